@@ -0,0 +1,181 @@
+#include "appstyle.h"
+#include <QApplication>
+#include <QLinearGradient>
+
+namespace AppStyle {
+
+const QString& styleSheet()
+{
+    static const QString sheet = QStringLiteral(
+        "QMainWindow { background-color: #E6FFEA; }"
+
+        // Login page
+        "#loginPage, #profilePage { background-color: #E6FFEA; }"
+        "#pandaFallback { font-size: 120px; }"
+        "#loginBox {"
+        "   background-color: white;"
+        "   border-radius: 20px;"
+        "   padding: 40px 30px 30px 30px;"
+        "}"
+        "#loginTitle {"
+        "   font-size: 28px;"
+        "   font-weight: bold;"
+        "   color: #6B3FA0;"
+        "   margin-bottom: 10px;"
+        "}"
+        "#loginInput {"
+        "   border: 1px solid #ccc;"
+        "   border-radius: 10px;"
+        "   padding: 0 15px;"
+        "   font-size: 14px;"
+        "}"
+        "#loginInput:focus { border: 1px solid #6B3FA0; }"
+        "#gradientButton {"
+        "   background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #FF1493, stop:1 #6B3FA0);"
+        "   color: white;"
+        "   border: none;"
+        "   border-radius: 10px;"
+        "   font-size: 16px;"
+        "   font-weight: bold;"
+        "}"
+        "#purpleButton {"
+        "   background-color: #6B3FA0;"
+        "   color: white;"
+        "   border: none;"
+        "   border-radius: 10px;"
+        "   font-size: 14px;"
+        "   font-weight: bold;"
+        "}"
+        "#purpleButton:checked, #purpleButton:hover { background-color: #4B2A70; }"
+
+        // Page headers
+        "#appHeader {"
+        "   background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #1a1a1a, stop:1 #6B3FA0);"
+        "   padding: 15px;"
+        "}"
+        "#appTitle { color: white; font-size: 20px; font-weight: bold; background: transparent; }"
+        "#pageTitle { color: white; font-size: 18px; font-weight: bold; background: transparent; }"
+        "#navButton {"
+        "   background: transparent;"
+        "   color: white;"
+        "   border: none;"
+        "   padding: 8px 15px;"
+        "   font-size: 14px;"
+        "}"
+        "#navButton:hover { background: rgba(255,255,255,0.2); border-radius: 5px; }"
+        "#backButton { background: transparent; color: white; border: none; font-size: 14px; }"
+
+        // Feed page
+        "#storiesView { background-color: #F5F5F5; border: none; }"
+        "#feedView { background-color: #E6FFEA; border: none; }"
+
+        // Messages page
+        "#messagesScroll, #messagesContainer { background-color: #F5F5F5; border: none; }"
+        "#outgoingBubble {"
+        "   background-color: #1a1a1a;"
+        "   border-radius: 15px;"
+        "   padding: 12px 16px;"
+        "}"
+        "#incomingBubble {"
+        "   background: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #6B3FA0, stop:1 #4B2A70);"
+        "   border-radius: 15px;"
+        "   padding: 12px 16px;"
+        "}"
+        "#bubbleSender { font-weight: bold; font-size: 12px; color: #FFD700; background: transparent; }"
+        "#bubbleContent { font-size: 14px; color: white; background: transparent; }"
+        "#bubbleTime { font-size: 11px; color: rgba(255,255,255,0.7); background: transparent; }"
+        "#inputArea { background-color: white; border-top: 1px solid #ddd; }"
+        "#messageInput {"
+        "   border: 1px solid #ccc;"
+        "   border-radius: 20px;"
+        "   padding: 10px 15px;"
+        "   font-size: 14px;"
+        "}"
+
+        // Profile page
+        "#profileAvatar {"
+        "   background: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #6B3FA0, stop:1 #FF1493);"
+        "   border-radius: 60px;"
+        "   border: 4px solid white;"
+        "}"
+        "#profileUsername { font-size: 24px; font-weight: bold; color: #333; }"
+        "#profileStats { font-size: 14px; color: #666; }"
+
+        // Search
+        "#searchInput {"
+        "   border: none;"
+        "   border-radius: 16px;"
+        "   padding: 6px 12px;"
+        "   font-size: 13px;"
+        "   background-color: rgba(255,255,255,0.9);"
+        "}"
+        "#searchUsers { background-color: white; padding: 8px 15px; font-size: 13px; color: #6B3FA0; }"
+
+        // Notifications page
+        "#notificationsList { background-color: #E6FFEA; border: none; font-size: 14px; color: #333; }"
+        "#notificationsList::item { padding: 12px 20px; border-bottom: 1px solid #D0EED5; }"
+    );
+    return sheet;
+}
+
+namespace {
+
+QFont pixelFont(const QFont& base, int pixelSize, bool bold = false)
+{
+    QFont font(base);
+    font.setPixelSize(pixelSize);
+    font.setBold(bold);
+    return font;
+}
+
+PaintPalette buildPaintPalette()
+{
+    PaintPalette p;
+
+    p.cardBackground = QBrush(Black);
+    p.avatarBackground = QBrush(Purple);
+
+    QLinearGradient content(0, 0, 0, 1);
+    content.setCoordinateMode(QGradient::ObjectBoundingMode);
+    content.setColorAt(0, Purple);
+    content.setColorAt(1, DeepPurple);
+    p.contentGradient = QBrush(content);
+
+    QLinearGradient ring(0, 0, 1, 1);
+    ring.setCoordinateMode(QGradient::ObjectBoundingMode);
+    ring.setColorAt(0, Pink);
+    ring.setColorAt(1, Purple);
+    p.storyRingGradient = QBrush(ring);
+
+    QLinearGradient closeFriends(0, 0, 1, 1);
+    closeFriends.setCoordinateMode(QGradient::ObjectBoundingMode);
+    closeFriends.setColorAt(0, QColor(0x2E, 0xCC, 0x71));
+    closeFriends.setColorAt(1, QColor(0x1A, 0x9E, 0x55));
+    p.closeFriendRing = QBrush(closeFriends);
+    p.seenRing = QBrush(QColor(0xCC, 0xCC, 0xCC));
+    p.mediaPlaceholder = QBrush(QColor(255, 255, 255, 40));
+
+    p.textPen = QPen(Qt::white);
+    p.mutedTextPen = QPen(MutedText);
+    p.outlineButtonPen = QPen(Pink, 1);
+    p.storyNamePen = QPen(QColor(0x33, 0x33, 0x33));
+
+    const QFont base = QApplication::font();
+    p.avatarFont = pixelFont(base, 18);
+    p.usernameFont = pixelFont(base, 15, true);
+    p.timestampFont = pixelFont(base, 12);
+    p.contentFont = pixelFont(base, 14);
+    p.buttonFont = pixelFont(base, 13);
+    p.storyNameFont = pixelFont(base, 11);
+    return p;
+}
+
+} // namespace
+
+const PaintPalette& paintPalette()
+{
+    static const PaintPalette palette = buildPaintPalette();
+    return palette;
+}
+
+} // namespace AppStyle
@@ -0,0 +1,64 @@
+#ifndef APPSTYLE_H
+#define APPSTYLE_H
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QPen>
+#include <QString>
+#include "shadowcache.h"
+
+// ============================================================================
+// APP STYLE
+// One application-level style sheet keyed by object names, set once on the
+// main window, plus the brushes, pens and fonts the delegates paint with.
+// Widgets only call setObjectName(); nothing parses QSS per item and no
+// painter state is rebuilt per card.
+// ============================================================================
+
+namespace AppStyle {
+
+// Theme colors
+const QColor Purple(0x6B, 0x3F, 0xA0);
+const QColor DeepPurple(0x4B, 0x2A, 0x70);
+const QColor Pink(0xFF, 0x14, 0x93);
+const QColor Black(0x1a, 0x1a, 0x1a);
+const QColor Mint(0xE6, 0xFF, 0xEA);
+const QColor LightGray(0xF5, 0xF5, 0xF5);
+const QColor MutedText(0x99, 0x99, 0x99);
+
+// Drop shadows (cached nine-patches, see ShadowCache)
+const ShadowCache::Style CardShadow = { 15, 15, QPoint(0, 5), QColor(0, 0, 0, 30) };
+const ShadowCache::Style LoginBoxShadow = { 30, 20, QPoint(0, 10), QColor(0, 0, 0, 50) };
+
+// Pre-built painting resources for item delegates. Gradients use
+// ObjectBoundingMode so one brush fits every card size.
+struct PaintPalette {
+    QBrush cardBackground;
+    QBrush avatarBackground;
+    QBrush contentGradient;      // Vertical purple bubble
+    QBrush storyRingGradient;    // Diagonal pink-to-purple ring
+    QBrush closeFriendRing;      // Green ring for close friends' stories
+    QBrush seenRing;             // Flat ring once a story has been viewed
+    QBrush mediaPlaceholder;     // Shown until post media is decoded
+    QPen textPen;
+    QPen mutedTextPen;
+    QPen outlineButtonPen;
+    QPen storyNamePen;
+    QFont avatarFont;
+    QFont usernameFont;
+    QFont timestampFont;
+    QFont contentFont;
+    QFont buttonFont;
+    QFont storyNameFont;
+};
+
+// Sheet for the whole window (parsed once when applied)
+const QString& styleSheet();
+
+// Built on first use from the application font
+const PaintPalette& paintPalette();
+
+} // namespace AppStyle
+
+#endif // APPSTYLE_H
@@ -0,0 +1,1206 @@
+#include "backendservice.h"
+#include "poststore.h"
+#include "messagestore.h"
+#include "feedranker.h"
+#include "writeaheadlog.h"
+#include "credentialstore.h"
+#include "socialgraph.h"
+#include "timelinestore.h"
+#include "notificationqueue.h"
+#include "searchindex.h"
+#include "storystore.h"
+#include "scratcharena.h"
+#include "trace.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+#include <QUuid>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const char* const PostsFile = "posts.dat";
+const char* const MessagesFile = "messages.dat";
+const char* const UsersFile = "users.dat";
+const char* const GraphFile = "graph.dat";
+const char* const MutationLogFile = "mutations.wal";
+const int SearchUserLimit = 5;   // Matching authors shown above the results
+const int StorySweepIntervalMs = 60 * 1000;
+
+// Ranking order shared by the ranker and the timelines
+bool ranksBefore(const RankedPost& a, const RankedPost& b)
+{
+    return a.score != b.score ? a.score > b.score : a.record > b.record;
+}
+
+// First pageSize posts of two ranked pages read from the same cursor
+RankedPage mergePages(const RankedPage& a, const RankedPage& b, int pageSize)
+{
+    RankedPage merged{ {}, a.next, a.atEnd && b.atEnd };
+    merged.posts.reserve(qMin(pageSize, a.posts.size() + b.posts.size()));
+    int i = 0;
+    int j = 0;
+    while (merged.posts.size() < pageSize && (i < a.posts.size() || j < b.posts.size())) {
+        const bool takeA = j == b.posts.size()
+            || (i < a.posts.size() && ranksBefore(a.posts.at(i), b.posts.at(j)));
+        merged.posts.append(takeA ? a.posts.at(i++) : b.posts.at(j++));
+    }
+    if (i < a.posts.size() || j < b.posts.size()) {
+        merged.atEnd = false;
+    }
+    if (!merged.posts.isEmpty()) {
+        const RankedPost& last = merged.posts.last();
+        merged.next = FeedRanker::encodeCursor(last.score, last.record);
+    }
+    return merged;
+}
+
+Message toMessage(const StoredMessage& stored, const QString& viewer)
+{
+    const bool outgoing = (stored.from == viewer);
+    return {
+        outgoing ? QString("You") : stored.from,
+        stored.text,
+        stored.sentAt,
+        outgoing
+    };
+}
+
+} // namespace
+
+BackendService::BackendService(QObject *parent)
+    : QObject(parent)
+    , m_credentials(new CredentialStore())
+    , m_postStore(new PostStore())
+    , m_feedRanker(new FeedRanker())
+    , m_timelines(new TimelineStore())
+    , m_searchIndex(new SearchIndex())
+    , m_messageStore(new MessageStore())
+    , m_graph(new SocialGraph())
+    , m_stories(new StoryStore())
+    , m_notifications(new NotificationQueue())
+    , m_wal(new WriteAheadLog())
+{
+    qRegisterMetaType<FeedPage>("FeedPage");
+    qRegisterMetaType<MessagePage>("MessagePage");
+    qRegisterMetaType<QVector<ConversationPreview>>("QVector<ConversationPreview>");
+    qRegisterMetaType<User>("User");
+    qRegisterMetaType<NotificationList>("NotificationList");
+    qRegisterMetaType<SearchResults>("SearchResults");
+    qRegisterMetaType<StoryRingList>("StoryRingList");
+    qRegisterMetaType<StoryPage>("StoryPage");
+    
+    // Enough workers for login to fetch feed, profile and messages at once
+    m_pool.setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+    
+    // GUI-thread mutations apply one at a time, in the order they were made
+    m_writer.setMaxThreadCount(1);
+    
+    if (!m_credentials->open(UsersFile)) {
+        qDebug() << "Could not open" << UsersFile << ":" << m_credentials->errorString();
+    }
+    
+    // Opened before replay so logged messages missing from it are re-added
+    if (!m_messageStore->open(MessagesFile)) {
+        qDebug() << "Could not open" << MessagesFile << ":" << m_messageStore->errorString();
+    }
+    
+    // Follows since the last save are replayed on top of it
+    if (!m_graph->open(GraphFile)) {
+        qDebug() << "Could not open" << GraphFile << ":" << m_graph->errorString();
+    }
+    
+    // Crash recovery: replay every mutation that reached the log. Messages
+    // are stored before their commit, so messages.dat can hold sequences a
+    // crash cut off the log; new records are numbered after those.
+    WriteAheadLog::Options walOptions;
+    walOptions.minSequence = m_messageStore->lastSequence();
+    m_replaying = true;
+    const bool walOpen = m_wal->open(MutationLogFile, [this](const WriteAheadLog::Record& record) {
+        applyLogRecord(record.type, record.sequence, record.payload);
+    }, walOptions);
+    m_replaying = false;
+    if (!walOpen) {
+        qDebug() << "Could not open" << MutationLogFile << ":" << m_wal->errorString();
+    }
+    
+    // Stories that expired while the app was closed, then every minute on
+    // a worker (whole buckets at a time, never a scan)
+    m_stories->sweep(QDateTime::currentSecsSinceEpoch());
+    m_storySweeper = new QTimer(this);
+    m_storySweeper->setInterval(StorySweepIntervalMs);
+    connect(m_storySweeper, &QTimer::timeout, this, [this]() {
+        m_pool.start([this]() {
+            m_stories->sweep(QDateTime::currentSecsSinceEpoch());
+        });
+    });
+    m_storySweeper->start();
+}
+
+BackendService::~BackendService()
+{
+    // Queued jobs still reference the stores; queued mutations still go
+    // into the log
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_writer.waitForDone();
+    
+    // Flushes the last batch. graph.dat belongs to the process that owns
+    // the log: another client sharing the directory would overwrite it.
+    const bool ownsLog = m_wal->isOpen();
+    m_wal->close();
+    if (!ownsLog) {
+        return;
+    }
+    
+    QWriteLocker locker(&m_graphLock);
+    if (!m_graph->save(GraphFile)) {
+        qDebug() << "Could not save" << GraphFile << ":" << m_graph->errorString();
+    }
+}
+
+// ============================================================================
+// ASYNC REQUESTS (GUI thread)
+// ============================================================================
+
+void BackendService::authenticate(const QString& username, const QString& password, bool createAccount)
+{
+    m_pool.start([this, username, password, createAccount]() {
+        const bool ok = authenticateUser(username, password, createAccount);
+        if (createAccount) {
+            Trace::count(ok ? "sign-ups" : "failed sign-ups");
+        } else {
+            Trace::count(ok ? "logins" : "failed logins");
+        }
+        emit authenticated(username, ok, ok ? m_credentials->createSession(username) : QByteArray());
+    });
+}
+
+void BackendService::requestFeedPage(const QString& username, const QByteArray& cursor, int pageSize,
+                                     int generation)
+{
+    m_pool.start([this, username, cursor, pageSize, generation]() {
+        FeedPage page = loadFeedPosts(username, cursor, pageSize);
+        page.generation = generation;
+        emit feedPageLoaded(page);
+    });
+}
+
+void BackendService::requestMessages(const QString& username, const QString& partner, int pageSize,
+                                     int before)
+{
+    m_pool.start([this, username, partner, pageSize, before]() {
+        emit messagesLoaded(loadMessages(username, partner, pageSize, before));
+    });
+}
+
+void BackendService::requestConversations(const QString& username, int limit)
+{
+    m_pool.start([this, username, limit]() {
+        emit conversationsLoaded(loadConversations(username, limit));
+    });
+}
+
+void BackendService::requestUserProfile(const QString& username)
+{
+    m_pool.start([this, username]() {
+        emit userProfileLoaded(loadUserProfile(username));
+    });
+}
+
+void BackendService::saveCloseFriendStatus(const QString& username, bool status)
+{
+    m_pool.start([this, username, status]() {
+        storeCloseFriendStatus(username, status);
+        emit closeFriendStatusSaved(status);
+    });
+}
+
+void BackendService::createPost(const QString& username, const QString& content)
+{
+    m_pool.start([this, username, content]() {
+        emit postCreated(storeNewPost(username, content));
+    });
+}
+
+void BackendService::requestNotifications(const QString& username, int limit)
+{
+    m_pool.start([this, username, limit]() {
+        emit notificationsLoaded(loadNotifications(username, limit));
+    });
+}
+
+void BackendService::requestStoryRings(const QString& username)
+{
+    m_pool.start([this, username]() {
+        emit storyRingsLoaded(loadStoryRings(username));
+    });
+}
+
+void BackendService::requestStories(const QString& username, const QString& author)
+{
+    m_pool.start([this, username, author]() {
+        emit storiesLoaded(loadStories(username, author));
+    });
+}
+
+void BackendService::createStory(const QString& username, const QString& caption)
+{
+    m_pool.start([this, username, caption]() {
+        emit storyCreated(storeNewStory(username, caption));
+    });
+}
+
+void BackendService::requestSearch(const QString& query, int limit, int generation)
+{
+    m_pool.start([this, query, limit, generation]() {
+        SearchResults results = loadSearchResults(query, limit);
+        results.generation = generation;
+        emit searchResultsLoaded(results);
+    });
+}
+
+int BackendService::unreadNotificationCount(const QString& username) const
+{
+    return m_notifications->unreadCount(m_credentials->userId(username));
+}
+
+// ============================================================================
+// MUTATIONS (write-ahead logged)
+// ============================================================================
+
+void BackendService::likePost(const QString& username, quint64 postId)
+{
+    const qint64 at = QDateTime::currentSecsSinceEpoch();
+    m_writer.start([this, username, postId, at]() {
+        // The author is resolved now so replay does not need posts.dat
+        QByteArray payload;
+        QDataStream(&payload, QIODevice::WriteOnly) << username << postId << postAuthor(postId) << at;
+        
+        const quint64 sequence = logMutation(WriteAheadLog::LikePost, payload);
+        applyLogRecord(WriteAheadLog::LikePost, sequence, payload);
+    });
+}
+
+void BackendService::sendMessage(const QString& from, const QString& to, const QString& text, int ticket)
+{
+    const qint64 sentAt = QDateTime::currentSecsSinceEpoch();
+    m_writer.start([this, from, to, text, sentAt, ticket]() {
+        emit messageStored(ticket, logMessage(from, to, text, sentAt));
+    });
+}
+
+void BackendService::notifyIncomingMessage(const QString& from, const QString& to, qint64 sentAt)
+{
+    // Storing it again would show every pushed message twice
+    m_writer.start([this, from, to, sentAt]() {
+        const quint32 sender = m_credentials->userId(from);
+        const quint32 recipient = m_credentials->userId(to);
+        notify(NotificationQueue::Message, recipient, sender, 0, isCloseFriendOf(recipient, sender), sentAt);
+    });
+}
+
+int BackendService::logMessage(const QString& from, const QString& to, const QString& text, qint64 sentAt)
+{
+    QByteArray payload;
+    QDataStream(&payload, QIODevice::WriteOnly) << from << to << text << sentAt;
+    
+    int index = -1;
+    const quint64 sequence = logMutation(WriteAheadLog::SendMessage, payload);
+    applyLogRecord(WriteAheadLog::SendMessage, sequence, payload, &index);
+    return index;
+}
+
+void BackendService::markNotificationsRead(const QString& username)
+{
+    m_writer.start([this, username]() {
+        QByteArray payload;
+        QDataStream(&payload, QIODevice::WriteOnly) << username;
+        
+        const quint64 sequence = logMutation(WriteAheadLog::NotificationsRead, payload);
+        applyLogRecord(WriteAheadLog::NotificationsRead, sequence, payload);
+    });
+}
+
+void BackendService::logGraphChange(int type, quint32 user, quint32 other, bool enabled)
+{
+    // Ids, not usernames: users.dat ids never change
+    QByteArray payload;
+    QDataStream(&payload, QIODevice::WriteOnly)
+        << user << other << enabled << QDateTime::currentSecsSinceEpoch();
+    
+    const WriteAheadLog::RecordType recordType = WriteAheadLog::RecordType(type);
+    const quint64 sequence = logMutation(recordType, payload);
+    applyLogRecord(recordType, sequence, payload);
+}
+
+quint64 BackendService::logMutation(int type, const QByteArray& payload)
+{
+    // No log (another client owns it), or one that refuses records after a
+    // failed commit: the change still applies in memory but will not
+    // survive a restart
+    const quint64 sequence = m_wal->isOpen() ? m_wal->append(WriteAheadLog::RecordType(type), payload) : 0;
+    if (sequence == 0 && m_walFailureReported.testAndSetOrdered(0, 1)) {
+        const QString error = m_wal->errorString();
+        qDebug() << "Mutations are no longer logged:" << error;
+        emit mutationLogFailed(error);
+    }
+    return sequence;
+}
+
+void BackendService::applyLogRecord(int type, quint64 sequence, const QByteArray& payload, int* messageIndex)
+{
+    // m_stateMutex covers only the two tables below; fan-out, indexing and
+    // notifications take their own locks and run without it
+    QDataStream in(payload);
+    
+    switch (type) {
+    case WriteAheadLog::LikePost: {
+        QString username;
+        quint64 postId = 0;
+        quint32 author = 0;
+        qint64 at = 0;
+        in >> username >> postId;
+        {
+            QMutexLocker locker(&m_stateMutex);
+            m_likesAdded[postId]++;
+        }
+        
+        // Older records carry no author
+        if (!in.atEnd()) {
+            in >> author >> at;
+            const quint32 actor = m_credentials->userId(username);
+            notify(NotificationQueue::Like, author, actor, postId, isCloseFriendOf(author, actor), at);
+        }
+        break;
+    }
+    case WriteAheadLog::SendMessage: {
+        StoredMessage msg;
+        msg.sequence = sequence;
+        in >> msg.from >> msg.to >> msg.text >> msg.sentAt;
+        QMutexLocker messageLocker(&m_messageMutex);
+        if (m_messageStore->isOpen() && !m_messageStore->append(msg)) {
+            qDebug() << "Could not store message:" << m_messageStore->errorString();
+        } else if (messageIndex && m_messageStore->isOpen()) {
+            *messageIndex = m_messageStore->conversationSize(msg.from, msg.to) - 1;
+        }
+        messageLocker.unlock();
+        
+        const quint32 sender = m_credentials->userId(msg.from);
+        const quint32 recipient = m_credentials->userId(msg.to);
+        notify(NotificationQueue::Message, recipient, sender, 0, isCloseFriendOf(recipient, sender), msg.sentAt);
+        break;
+    }
+    case WriteAheadLog::CloseFriendStatus: {
+        QString username;
+        bool status = false;
+        in >> username >> status;
+        QMutexLocker locker(&m_stateMutex);
+        m_closeFriendMode[username] = status;
+        break;
+    }
+    case WriteAheadLog::Follow:
+    case WriteAheadLog::CloseFriend: {
+        // Idempotent, so records already folded into graph.dat replay harmlessly
+        quint32 user = 0;
+        quint32 other = 0;
+        bool enabled = false;
+        qint64 at = QDateTime::currentSecsSinceEpoch();
+        in >> user >> other >> enabled;
+        if (!in.atEnd()) {
+            in >> at;
+        }
+        bool changed = false;
+        bool leftCelebrities = false;
+        {
+            QWriteLocker graphLocker(&m_graphLock);
+            if (type == WriteAheadLog::Follow) {
+                changed = enabled ? m_graph->follow(user, other) : m_graph->unfollow(user, other);
+                leftCelebrities = changed && !enabled
+                    && m_graph->followerCount(other) == m_timelines->options().celebrityFollowers;
+            } else {
+                changed = m_graph->setCloseFriend(user, other, enabled);
+            }
+        }
+        
+        // The viewer's lanes were built for the old graph. An author who
+        // drops to the celebrity threshold stops being read on demand, but
+        // their recent posts were never pushed: rebuild every timeline.
+        if (changed) {
+            QWriteLocker feedLocker(&m_feedLock);
+            if (leftCelebrities) {
+                m_timelines->clear();
+            } else {
+                m_timelines->evict(user);
+            }
+        }
+        
+        // Replay rebuilds notifications for edges graph.dat already has
+        if (enabled && (changed || m_replaying)) {
+            if (type == WriteAheadLog::Follow) {
+                notify(NotificationQueue::Follow, other, user, 0, isCloseFriendOf(other, user), at);
+            } else {
+                notify(NotificationQueue::CloseFriend, other, user, 0, true, at);
+            }
+        }
+        break;
+    }
+    case WriteAheadLog::CreatePost: {
+        StoredPost post{ 0, 0, 0, 0, 0, 0, QString(), QString(), QString() };
+        in >> post.postId >> post.authorId >> post.createdAt >> post.username >> post.content;
+        {
+            QWriteLocker feedLocker(&m_feedLock);
+            m_nextPostId = qMax(m_nextPostId, post.postId + 1);
+            m_createdPosts.append(post);
+            
+            // Before posts.dat is open (replay) the post is added with the rest
+            if (m_feedReady) {
+                const quint32 record = quint32(m_postStore->count()) + quint32(m_createdPosts.size() - 1);
+                m_feedRanker->addPost(post.authorId, record, post.createdAt);
+                fanOut(post, record);
+            }
+        }
+        syncSearchIndex(false);
+        notifyNewPost(post);
+        break;
+    }
+    case WriteAheadLog::CreateStory: {
+        quint32 authorId = 0;
+        QString username;
+        QString caption;
+        QString media;
+        qint64 createdAt = 0;
+        in >> authorId >> username >> caption >> media >> createdAt;
+        m_stories->add(authorId, username, caption, media, createdAt);
+        break;
+    }
+    case WriteAheadLog::NotificationsRead: {
+        QString username;
+        in >> username;
+        const quint32 user = m_credentials->userId(username);
+        if (m_notifications->markAllRead(user)) {
+            emit notificationsChanged(username, m_notifications->unreadCount(user),
+                                      m_notifications->priorityUnreadCount(user));
+        }
+        break;
+    }
+    default:
+        qDebug() << "WAL: skipping unknown record type" << type;
+        break;
+    }
+}
+
+// ============================================================================
+// BACKEND INTEGRATION HOOKS (worker threads)
+// ============================================================================
+
+bool BackendService::authenticateUser(const QString& username, const QString& password, bool createAccount)
+{
+    Trace::Scope scope("authenticateUser");
+    if (username.isEmpty() || password.isEmpty() || !m_credentials->isOpen()) {
+        return false;
+    }
+    
+    // First run registers the sample authors along with posts.dat; that has
+    // to happen before anyone can sign up or log in under their names
+    openPostStore();
+    
+    // Sign-up fails for a taken name (checked again under the store's lock)
+    if (createAccount) {
+        if (!m_credentials->registerUser(username, password)) {
+            qDebug() << "Sign-up failed:" << m_credentials->errorString();
+            return false;
+        }
+        followFeaturedAuthors(username);
+        return true;
+    }
+    
+    // Salted PBKDF2, or a cache hit for a login verified recently. Unknown
+    // names fail like a wrong password.
+    return m_credentials->verify(username, password);
+}
+
+bool BackendService::openPostStore()
+{
+    QMutexLocker locker(&m_storeMutex);
+    if (m_postStore->isOpen()) {
+        return true;
+    }
+    
+    // First run: seed posts.dat with the sample feed
+    if (!QFile::exists(PostsFile)) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        QVector<StoredPost> samples;
+        
+        // Sample authors get accounts so their author ids are users.dat ids
+        // the social graph can follow
+        auto authorId = [this](const QString& name) {
+            if (!m_credentials->contains(name)) {
+                m_credentials->registerUser(name, QUuid::createUuid().toString());
+            }
+            return m_credentials->userId(name);
+        };
+        
+        samples.append({
+            1, authorId("alice_wonder"), now - 2 * 3600, 142, 23, PostRecord::FlagPriority,
+            "alice_wonder",
+            "Just had the most amazing coffee at the new café downtown! ☕✨ The ambiance is perfect for working on creative projects. Highly recommend!",
+            ""
+        });
+        
+        samples.append({
+            2, authorId("bob_builder"), now - 5 * 3600, 89, 15, 0,
+            "bob_builder",
+            "Finally finished my C++ project! 🎉 The feeling of seeing everything compile without errors is unmatched. Time to celebrate! 🚀",
+            ""
+        });
+        
+        samples.append({
+            3, authorId("charlie_dev"), now - 24 * 3600, 256, 47, PostRecord::FlagPriority,
+            "charlie_dev",
+            "Hot take: Qt is underrated for building desktop apps in 2025. The widget system is so powerful and the cross-platform support is chef's kiss 👨‍🍳💋",
+            ""
+        });
+        
+        QString error;
+        if (!PostStore::write(PostsFile, samples, &error)) {
+            qDebug() << "Could not create" << PostsFile << ":" << error;
+            return false;
+        }
+    }
+    
+    if (!m_postStore->open(PostsFile)) {
+        qDebug() << "Could not open" << PostsFile << ":" << m_postStore->errorString();
+        return false;
+    }
+    
+    // Split the store into per-author streams for the ranker
+    QWriteLocker feedLocker(&m_feedLock);
+    m_feedRanker->clear();
+    m_timelines->clear();
+    m_featuredAuthors.clear();
+    const quint64 count = m_postStore->count();
+    for (quint64 i = 0; i < count; ++i) {
+        const PostRecord& record = m_postStore->record(i);
+        m_feedRanker->addPost(record.authorId, quint32(i), record.createdAt);
+        m_nextPostId = qMax(m_nextPostId, record.postId + 1);
+        bool& priority = m_featuredAuthors[record.authorId];
+        priority = priority || (record.flags & PostRecord::FlagPriority);
+    }
+    
+    // A few stories from the sample authors so the bar is not empty. Not
+    // logged: they are recreated on each start and expire like any other.
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const QStringList captions = {
+        "☕ Morning coffee run", "🚀 Shipping day!", "🌆 Sunset from the office"
+    };
+    int sample = 0;
+    for (auto it = m_featuredAuthors.constBegin(); it != m_featuredAuthors.constEnd(); ++it, ++sample) {
+        m_stories->add(it.key(), m_credentials->username(it.key()), captions.at(sample % captions.size()),
+                       QString(), now - (sample + 1) * 3600);
+    }
+    
+    // Posts created since, replayed from the WAL
+    for (int i = 0; i < m_createdPosts.size(); ++i) {
+        m_feedRanker->addPost(m_createdPosts.at(i).authorId, quint32(count + i), m_createdPosts.at(i).createdAt);
+    }
+    m_feedReady = true;
+    return true;
+}
+
+bool BackendService::storeNewPost(const QString& username, const QString& content)
+{
+    const quint32 authorId = m_credentials->userId(username);
+    if (authorId == 0 || content.trimmed().isEmpty() || !openPostStore()) {
+        return false;
+    }
+    
+    quint64 postId = 0;
+    {
+        QWriteLocker locker(&m_feedLock);
+        postId = m_nextPostId++;
+    }
+    
+    QByteArray payload;
+    QDataStream(&payload, QIODevice::WriteOnly)
+        << postId << authorId << QDateTime::currentSecsSinceEpoch() << username << content;
+    
+    const quint64 sequence = logMutation(WriteAheadLog::CreatePost, payload);
+    applyLogRecord(WriteAheadLog::CreatePost, sequence, payload);
+    return true;
+}
+
+void BackendService::followFeaturedAuthors(const QString& username)
+{
+    // New accounts start out following the feed's authors, with the ones
+    // who post priority content as close friends
+    const quint32 user = m_credentials->userId(username);
+    if (user == 0 || !openPostStore()) {
+        return;
+    }
+    
+    QHash<quint32, bool> authors;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        authors = m_featuredAuthors;
+    }
+    for (auto it = authors.constBegin(); it != authors.constEnd(); ++it) {
+        if (it.key() == 0 || it.key() == user) {
+            continue;
+        }
+        logGraphChange(WriteAheadLog::Follow, user, it.key(), true);
+        if (it.value()) {
+            logGraphChange(WriteAheadLog::CloseFriend, user, it.key(), true);
+        }
+    }
+}
+
+Post BackendService::postFromRecord(quint64 recordIndex)
+{
+    Post post;
+    if (recordIndex < m_postStore->count()) {
+        // Text fields reference the mapped file directly (no copies)
+        const PostRecord& record = m_postStore->record(recordIndex);
+        post.username = m_postStore->string(record.username);
+        post.content = m_postStore->string(record.content);
+        post.createdAt = record.createdAt;
+        post.likes = record.likes;
+        post.comments = record.comments;
+        post.isPriority = (record.flags & PostRecord::FlagPriority) != 0;
+        post.media = m_postStore->string(record.media);
+        post.postId = record.postId;
+    } else {
+        // Created since posts.dat was written
+        StoredPost stored;
+        {
+            QReadLocker locker(&m_feedLock);
+            stored = m_createdPosts.value(int(recordIndex - m_postStore->count()));
+        }
+        post.username = stored.username;
+        post.content = stored.content;
+        post.createdAt = stored.createdAt;
+        post.likes = stored.likes;
+        post.comments = stored.comments;
+        post.isPriority = false;
+        post.media = stored.media;
+        post.postId = stored.postId;
+    }
+    
+    QMutexLocker locker(&m_stateMutex);
+    post.likes += m_likesAdded.value(post.postId);
+    return post;
+}
+
+FeedPage BackendService::loadFeedPosts(const QString& username, const QByteArray& cursor, int pageSize)
+{
+    Trace::Scope scope("loadFeedPosts");
+    FeedPage page{ {}, cursor, true };
+    if (!openPostStore()) {
+        return page;
+    }
+    
+    bool closeFriendsOnly = false;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        closeFriendsOnly = m_closeFriendMode.value(username);
+    }
+    
+    // Next page of the feed: close friends boosted, newest first. Close
+    // Friends Mode limits it to their posts.
+    const RankedPage ranked = rankFeed(m_credentials->userId(username), cursor, pageSize, closeFriendsOnly);
+    page.posts.reserve(ranked.posts.size());
+    for (const RankedPost& entry : ranked.posts) {
+        Post post = postFromRecord(entry.record);
+        post.isPriority = entry.isPriority;
+        page.posts.append(post);
+    }
+    page.nextCursor = ranked.next;
+    page.atEnd = ranked.atEnd;
+    Trace::count("feed posts loaded", page.posts.size());
+    
+    return page;
+}
+
+MessagePage BackendService::loadMessages(const QString& username, const QString& partner, int pageSize,
+                                         int before)
+{
+    Trace::Scope scope("loadMessages");
+    MessagePage page;
+    page.viewer = username;
+    page.partner = partner;
+    page.before = before;
+    
+    QMutexLocker locker(&m_messageMutex);
+    if (!m_messageStore->isOpen()) {
+        return page;
+    }
+    m_messageStore->refresh();   // Messages other clients stored since
+    
+    // First visit: seed messages.dat with the sample chat
+    if (m_messageStore->conversationSize(username, partner) == 0) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        const QVector<StoredMessage> samples = {
+            { 0, now - 5 * 60, partner, username, "Hey! Did you see the new features?" },
+            { 0, now - 3 * 60, username, partner, "Yes! The UI looks amazing with the new design!" },
+            { 0, now - 2 * 60, partner, username, "I know right! The panda login screen is so cute 🐼" },
+            { 0, now, username, partner, "Haha yes! Can't wait to show this to everyone" }
+        };
+        for (const StoredMessage& sample : samples) {
+            if (!m_messageStore->append(sample)) {
+                qDebug() << "Could not seed" << MessagesFile << ":" << m_messageStore->errorString();
+                break;
+            }
+        }
+    }
+    
+    // One page only: reads pageSize frames, not the whole conversation
+    page.total = m_messageStore->conversationSize(username, partner);
+    const int end = (before < 0 || before > page.total) ? page.total : before;
+    page.firstIndex = qMax(0, end - pageSize);
+    
+    const QVector<StoredMessage> stored = m_messageStore->conversation(username, partner, pageSize, end);
+    page.messages.reserve(stored.size());
+    for (const StoredMessage& msg : stored) {
+        Message message = toMessage(msg, username);
+        message.index = page.firstIndex + page.messages.size();
+        page.messages.append(message);
+    }
+    return page;
+}
+
+QVector<ConversationPreview> BackendService::loadConversations(const QString& username, int limit)
+{
+    QVector<ConversationPreview> previews;
+    QMutexLocker locker(&m_messageMutex);
+    if (!m_messageStore->isOpen()) {
+        return previews;
+    }
+    m_messageStore->refresh();
+    
+    const QVector<ConversationSummary> summaries = m_messageStore->conversations(username, limit);
+    previews.reserve(summaries.size());
+    for (const ConversationSummary& summary : summaries) {
+        previews.append({
+            summary.partner,
+            summary.last.text,
+            summary.last.sentAt,
+            summary.messageCount
+        });
+    }
+    return previews;
+}
+
+User BackendService::loadUserProfile(const QString& username)
+{
+    Trace::Scope scope("loadUserProfile");
+    User profile;
+    profile.username = username.isEmpty() ? "demo_user" : username;
+    profile.displayName = "Demo User";
+    profile.avatarPath = "";
+    profile.isCloseFriend = false;
+    
+    // Degrees are O(1) in the graph
+    const quint32 userId = m_credentials->userId(username);
+    QReadLocker locker(&m_graphLock);
+    profile.followerCount = m_graph->followerCount(userId);
+    profile.followingCount = m_graph->followingCount(userId);
+    
+    return profile;
+}
+
+void BackendService::storeCloseFriendStatus(const QString& username, bool status)
+{
+    QByteArray payload;
+    QDataStream(&payload, QIODevice::WriteOnly) << username << status;
+    
+    const quint64 sequence = logMutation(WriteAheadLog::CloseFriendStatus, payload);
+    applyLogRecord(WriteAheadLog::CloseFriendStatus, sequence, payload);
+    
+    qDebug() << "Close friend status updated:" << username << status;
+}
+
+// ============================================================================
+// HOME TIMELINES
+// ============================================================================
+
+RankedPage BackendService::rankFeed(quint32 viewer, const QByteArray& cursor, int pageSize,
+                                    bool closeFriendsOnly)
+{
+    const RankedPage empty{ {}, cursor, true };
+    
+    // Followed authors, with the celebrities among them (never pushed).
+    // Copied once per page into sorted sets on this thread's scratch arena,
+    // released together when the page is built.
+    ScratchArena::Scope scratch;
+    AuthorSet closeFriends(scratch.resource());
+    AuthorSet authors(scratch.resource());
+    AuthorSet celebrities(scratch.resource());
+    bool followsAnyone = false;
+    {
+        QReadLocker locker(&m_graphLock);
+        m_graph->appendCloseFriends(viewer, &closeFriends.ids());
+        closeFriends.sort();
+        for (quint32 followee : m_graph->following(viewer)) {
+            followsAnyone = true;
+            if (closeFriendsOnly && !closeFriends.contains(followee)) {
+                continue;
+            }
+            authors.add(followee);
+            if (m_timelines->isCelebrity(m_graph->followerCount(followee))) {
+                celebrities.add(followee);
+            }
+        }
+    }
+    authors.sort();
+    celebrities.sort();
+    
+    QReadLocker feedLocker(&m_feedLock);
+    
+    // Follows nobody (accounts from before the graph): everyone's posts
+    if (viewer == 0 || !followsAnyone) {
+        if (closeFriendsOnly && closeFriends.isEmpty()) {
+            return empty;
+        }
+        return closeFriendsOnly ? m_feedRanker->page(cursor, pageSize, closeFriends, closeFriends)
+                                : m_feedRanker->page(cursor, pageSize, closeFriends);
+    }
+    if (!closeFriendsOnly) {
+        authors.add(viewer);
+        authors.sort();
+    } else if (authors.isEmpty()) {
+        return empty;
+    }
+    
+    if (!m_timelines->isMaterialized(viewer)) {
+        feedLocker.unlock();
+        materializeTimeline(viewer);
+        feedLocker.relock();
+    }
+    
+    // Evicted again in between: read the author streams this once
+    if (!m_timelines->isMaterialized(viewer)) {
+        return m_feedRanker->page(cursor, pageSize, closeFriends, authors);
+    }
+    
+    bool truncated = false;
+    const RankedPage timeline = m_timelines->page(viewer, cursor, pageSize, m_feedRanker->closeFriendBoost(),
+                                                  celebrities, closeFriendsOnly, &truncated);
+    RankedPage ranked = timeline;
+    if (!celebrities.isEmpty()) {
+        ranked = mergePages(timeline, m_feedRanker->page(cursor, pageSize, closeFriends, celebrities),
+                            pageSize);
+    }
+    
+    if (truncated) {
+        // Paged past what the timeline kept: keep what ranks above its last
+        // entry and continue from the author streams
+        int keep = 0;
+        if (!timeline.posts.isEmpty()) {
+            const RankedPost& edge = timeline.posts.last();
+            while (keep < ranked.posts.size() && !ranksBefore(edge, ranked.posts.at(keep))) {
+                ++keep;
+            }
+        }
+        ranked.posts.resize(keep);
+        ranked.next = keep > 0 ? FeedRanker::encodeCursor(ranked.posts.last().score, ranked.posts.last().record)
+                               : cursor;
+        ranked.atEnd = false;
+        if (keep < pageSize) {
+            const RankedPage rest = m_feedRanker->page(ranked.next, pageSize - keep, closeFriends, authors);
+            ranked.posts += rest.posts;
+            ranked.next = rest.next;
+            ranked.atEnd = rest.atEnd;
+        }
+    }
+    return ranked;
+}
+
+void BackendService::materializeTimeline(quint32 viewer)
+{
+    QWriteLocker feedLocker(&m_feedLock);
+    if (m_timelines->isMaterialized(viewer)) {
+        return;
+    }
+    
+    // Lanes as fan-out would have filled them: close friends in the
+    // priority lane, other followees and the viewer in the regular one
+    ScratchArena::Scope scratch;
+    AuthorSet regular(scratch.resource());
+    AuthorSet priority(scratch.resource());
+    regular.add(viewer);
+    {
+        QReadLocker graphLocker(&m_graphLock);
+        for (quint32 followee : m_graph->following(viewer)) {
+            if (m_timelines->isCelebrity(m_graph->followerCount(followee))) {
+                continue;
+            }
+            (m_graph->isCloseFriend(viewer, followee) ? priority : regular).add(followee);
+        }
+    }
+    regular.sort();
+    priority.sort();
+    
+    // Fan-out on read, once: one post past capacity tells whether older ones exist
+    auto latest = [this](const AuthorSet& authors, int capacity, bool* complete) {
+        QVector<RankedPost> posts;
+        if (!authors.isEmpty()) {
+            posts = m_feedRanker->topK(capacity + 1, AuthorSet(), authors);
+        }
+        *complete = posts.size() <= capacity;
+        return posts;
+    };
+    bool regularComplete = true;
+    bool priorityComplete = true;
+    const QVector<RankedPost> regularPosts = latest(regular, m_timelines->options().regularCapacity,
+                                                    &regularComplete);
+    const QVector<RankedPost> priorityPosts = latest(priority, m_timelines->options().priorityCapacity,
+                                                     &priorityComplete);
+    m_timelines->materialize(viewer, regularPosts, regularComplete, priorityPosts, priorityComplete);
+}
+
+void BackendService::fanOut(const StoredPost& post, quint32 record)
+{
+    // Caller holds m_feedLock for writing
+    const TimelineEntry entry{ post.createdAt, record, post.authorId };
+    m_timelines->push(post.authorId, TimelineStore::RegularLane, entry);
+    
+    QReadLocker graphLocker(&m_graphLock);
+    if (m_timelines->isCelebrity(m_graph->followerCount(post.authorId))) {
+        return;   // Followers read it from the author's stream
+    }
+    for (quint32 follower : m_graph->followers(post.authorId)) {
+        const bool closeFriend = m_graph->isCloseFriend(follower, post.authorId);
+        m_timelines->push(follower, closeFriend ? TimelineStore::PriorityLane : TimelineStore::RegularLane,
+                          entry);
+    }
+}
+
+// ============================================================================
+// NOTIFICATIONS
+// ============================================================================
+
+NotificationList BackendService::loadNotifications(const QString& username, int limit)
+{
+    NotificationList list;
+    list.username = username;
+    
+    const quint32 user = m_credentials->userId(username);
+    for (bool priority : { true, false }) {
+        QVector<Notification>& lane = priority ? list.priority : list.regular;
+        for (const NotificationQueue::Row& row : m_notifications->rows(user, priority, limit)) {
+            lane.append({ NotificationQueue::describe(row), row.updatedAt, row.priority, row.unread });
+        }
+    }
+    return list;
+}
+
+void BackendService::notify(int kind, quint32 recipient, quint32 actor, quint64 target, bool priority, qint64 at)
+{
+    if (recipient == 0 || actor == 0 || recipient == actor) {
+        return;
+    }
+    
+    const QString actorName = m_credentials->username(actor);
+    m_notifications->post({ NotificationQueue::Kind(kind), recipient, actor, actorName, target, priority, at });
+    
+    // Coalesced events change the list even when the count stays put
+    emit notificationsChanged(m_credentials->username(recipient), m_notifications->unreadCount(recipient),
+                              m_notifications->priorityUnreadCount(recipient));
+}
+
+void BackendService::notifyNewPost(const StoredPost& post)
+{
+    // Followers who count the author as a close friend hear about new posts.
+    // Like fan-out, celebrities' followers are not walked on every post.
+    QVector<quint32> recipients;
+    {
+        QReadLocker locker(&m_graphLock);
+        if (m_timelines->isCelebrity(m_graph->followerCount(post.authorId))) {
+            return;
+        }
+        for (quint32 follower : m_graph->followers(post.authorId)) {
+            if (m_graph->isCloseFriend(follower, post.authorId)) {
+                recipients.append(follower);
+            }
+        }
+    }
+    for (quint32 recipient : recipients) {
+        notify(NotificationQueue::NewPost, recipient, post.authorId, post.postId, true, post.createdAt);
+    }
+}
+
+bool BackendService::isCloseFriendOf(quint32 user, quint32 other) const
+{
+    QReadLocker locker(&m_graphLock);
+    return m_graph->isCloseFriend(user, other);
+}
+
+quint32 BackendService::postAuthor(quint64 postId) const
+{
+    QReadLocker locker(&m_feedLock);
+    if (!m_feedReady) {
+        return 0;
+    }
+    const qint64 record = m_postStore->findById(postId);
+    if (record >= 0) {
+        return m_postStore->record(quint64(record)).authorId;
+    }
+    for (int i = m_createdPosts.size() - 1; i >= 0; --i) {
+        if (m_createdPosts.at(i).postId == postId) {
+            return m_createdPosts.at(i).authorId;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+
+SearchResults BackendService::loadSearchResults(const QString& query, int limit)
+{
+    SearchResults results;
+    results.query = query;
+    if (query.trimmed().isEmpty() || !openPostStore()) {
+        return results;
+    }
+    syncSearchIndex(true);
+    
+    QVector<quint32> records;
+    {
+        QReadLocker locker(&m_searchLock);
+        for (quint32 doc : m_searchIndex->search(query, limit)) {
+            records.append(m_searchRecords.at(int(doc)));
+        }
+        results.users = m_searchIndex->searchUsers(query, SearchUserLimit);
+    }
+    results.posts.reserve(records.size());
+    for (quint32 record : records) {
+        results.posts.append(postFromRecord(record));
+    }
+    return results;
+}
+
+void BackendService::syncSearchIndex(bool build)
+{
+    QWriteLocker searchLocker(&m_searchLock);
+    if (!m_searchReady && !build) {
+        return;   // Nobody has searched yet; the first query indexes everything
+    }
+    
+    QReadLocker feedLocker(&m_feedLock);
+    if (!m_feedReady) {
+        return;
+    }
+    const quint32 count = quint32(m_postStore->count());
+    if (!m_searchReady) {
+        // posts.dat oldest first, so document ids follow creation time
+        QVector<quint32> order(int(count));
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [this](quint32 a, quint32 b) {
+            return m_postStore->record(a).createdAt < m_postStore->record(b).createdAt;
+        });
+        m_searchRecords.reserve(order.size() + m_createdPosts.size());
+        for (quint32 record : order) {
+            const PostRecord& post = m_postStore->record(record);
+            m_searchIndex->addDocument(m_postStore->string(post.username), m_postStore->string(post.content));
+            m_searchRecords.append(record);
+        }
+        m_searchReady = true;
+    }
+    
+    // Posts created since the last sync are always the newest
+    for (; m_searchCreatedIndexed < m_createdPosts.size(); ++m_searchCreatedIndexed) {
+        const StoredPost& post = m_createdPosts.at(m_searchCreatedIndexed);
+        m_searchIndex->addDocument(post.username, post.content);
+        m_searchRecords.append(count + quint32(m_searchCreatedIndexed));
+    }
+}
+
+// ============================================================================
+// STORIES
+// ============================================================================
+
+StoryRingList BackendService::loadStoryRings(const QString& username)
+{
+    StoryRingList list;
+    list.username = username;
+    const quint32 viewer = m_credentials->userId(username);
+    if (viewer == 0 || !openPostStore()) {
+        return list;
+    }
+    
+    QVector<quint32> following;
+    QSet<quint32> closeFriends;
+    {
+        QReadLocker locker(&m_graphLock);
+        following = m_graph->following(viewer);
+        closeFriends = m_graph->closeFriendSet(viewer);
+    }
+    
+    // Own ring first, even when empty, so there is always somewhere to post
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const StoryStore::Summary own = m_stories->summary(viewer, now);
+    list.rings.append({ username, own.count, own.count > 0 ? own.latestAt : 0, false, true });
+    
+    struct Candidate {
+        quint32 author;
+        StoryStore::Summary summary;
+        bool closeFriend;
+    };
+    QVector<Candidate> candidates;
+    for (quint32 author : following) {
+        const StoryStore::Summary summary = m_stories->summary(author, now);
+        if (summary.count > 0) {
+            candidates.append({ author, summary, closeFriends.contains(author) });
+        }
+    }
+    
+    // Close friends first, newest story first within each group
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.closeFriend != b.closeFriend) {
+            return a.closeFriend;
+        }
+        return a.summary.latestAt > b.summary.latestAt;
+    });
+    list.rings.reserve(list.rings.size() + candidates.size());
+    for (const Candidate& candidate : candidates) {
+        list.rings.append({ m_credentials->username(candidate.author), candidate.summary.count,
+                            candidate.summary.latestAt, candidate.closeFriend, false });
+    }
+    return list;
+}
+
+StoryPage BackendService::loadStories(const QString& username, const QString& author)
+{
+    StoryPage page;
+    page.viewer = username;
+    page.author = author;
+    
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (const StoryStore::Story& story : m_stories->stories(m_credentials->userId(author), now)) {
+        page.stories.append({ story.author, story.caption, story.media, story.createdAt });
+    }
+    return page;
+}
+
+bool BackendService::storeNewStory(const QString& username, const QString& caption)
+{
+    const quint32 authorId = m_credentials->userId(username);
+    if (authorId == 0 || caption.trimmed().isEmpty()) {
+        return false;
+    }
+    
+    QByteArray payload;
+    QDataStream(&payload, QIODevice::WriteOnly)
+        << authorId << username << caption << QString() << QDateTime::currentSecsSinceEpoch();
+    
+    const quint64 sequence = logMutation(WriteAheadLog::CreateStory, payload);
+    applyLogRecord(WriteAheadLog::CreateStory, sequence, payload);
+    return true;
+}
@@ -0,0 +1,200 @@
+#ifndef BACKENDSERVICE_H
+#define BACKENDSERVICE_H
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <QSet>
+#include <QThreadPool>
+#include "datatypes.h"
+#include "poststore.h"
+
+class MessageStore;
+class FeedRanker;
+class WriteAheadLog;
+class CredentialStore;
+class SocialGraph;
+class TimelineStore;
+class NotificationQueue;
+class SearchIndex;
+class StoryStore;
+class QTimer;
+struct RankedPage;
+
+// ============================================================================
+// BACKEND SERVICE
+// Runs the backend hooks (.dat file access) on a private thread pool so the
+// GUI thread never blocks on disk. Every request returns immediately; the
+// result is emitted from the worker and reaches receivers in the GUI thread
+// through a queued connection. Independent requests run in parallel.
+// Mutations are appended to the write-ahead log (group-committed off the
+// GUI thread) and replayed on startup; the ones made from GUI slots are
+// applied on a one-thread writer pool, so they keep their order without
+// taking the state locks on the GUI thread. New posts are fanned out to
+// their followers' materialized timelines as they are applied.
+// ============================================================================
+
+class BackendService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BackendService(QObject *parent = nullptr);
+    ~BackendService();
+
+    // Logs in, or with createAccount registers a new user (fails if taken)
+    void authenticate(const QString& username, const QString& password, bool createAccount = false);
+    void requestFeedPage(const QString& username, const QByteArray& cursor, int pageSize,
+                         int generation);
+    // Newest page of the chat, or the page ending just before position before
+    void requestMessages(const QString& username, const QString& partner, int pageSize,
+                         int before = -1);
+    void requestConversations(const QString& username, int limit);
+    void requestUserProfile(const QString& username);
+    void saveCloseFriendStatus(const QString& username, bool status);
+    void createPost(const QString& username, const QString& content);
+    void requestNotifications(const QString& username, int limit);
+    // Story circles for the viewer's bar, then one author's stories on demand
+    void requestStoryRings(const QString& username);
+    void requestStories(const QString& username, const QString& author);
+    void createStory(const QString& username, const QString& caption);
+    // Posts matching every word, the last one as a prefix (search-as-you-type)
+    void requestSearch(const QString& query, int limit, int generation);
+    
+    // Unread notifications, kept current as events arrive (O(1), any thread)
+    int unreadNotificationCount(const QString& username) const;
+
+    // Mutations: logged to the WAL, durable after the next group commit.
+    // The GUI-thread ones are applied by the ordered writer, in call order;
+    // each message comes back through messageStored() with its ticket.
+    void likePost(const QString& username, quint64 postId);
+    void sendMessage(const QString& from, const QString& to, const QString& text, int ticket = 0);
+    
+    // A message pushed over the bus. The sender's client already stored it
+    // in the shared messages.dat, so this only raises the recipient's
+    // notification (not logged).
+    void notifyIncomingMessage(const QString& from, const QString& to, qint64 sentAt);
+    void markNotificationsRead(const QString& username);
+
+signals:
+    void authenticated(const QString& username, bool ok, const QByteArray& sessionToken);
+    void feedPageLoaded(const FeedPage& page);
+    void messagesLoaded(const MessagePage& page);
+    void conversationsLoaded(const QVector<ConversationPreview>& conversations);
+    void userProfileLoaded(const User& profile);
+    void closeFriendStatusSaved(bool status);
+    // Position of a sent or pushed message in its conversation (-1 if not stored)
+    void messageStored(int ticket, int index);
+    void postCreated(bool ok);
+    void notificationsLoaded(const NotificationList& notifications);
+    void notificationsChanged(const QString& username, int unread, int priorityUnread);
+    void searchResultsLoaded(const SearchResults& results);
+    void storyRingsLoaded(const StoryRingList& rings);
+    void storiesLoaded(const StoryPage& page);
+    void storyCreated(bool ok);
+    // The mutation log stopped accepting records, or never opened because
+    // another process owns it (emitted once)
+    void mutationLogFailed(const QString& error);
+
+private:
+    // Blocking backend hooks (worker threads only)
+    bool authenticateUser(const QString& username, const QString& password, bool createAccount);
+    FeedPage loadFeedPosts(const QString& username, const QByteArray& cursor, int pageSize);
+    MessagePage loadMessages(const QString& username, const QString& partner, int pageSize, int before);
+    QVector<ConversationPreview> loadConversations(const QString& username, int limit);
+    User loadUserProfile(const QString& username);
+    void storeCloseFriendStatus(const QString& username, bool status);
+    bool storeNewPost(const QString& username, const QString& content);
+    NotificationList loadNotifications(const QString& username, int limit);
+    SearchResults loadSearchResults(const QString& query, int limit);
+    StoryRingList loadStoryRings(const QString& username);
+    StoryPage loadStories(const QString& username, const QString& author);
+    bool storeNewStory(const QString& username, const QString& caption);
+
+    // Returns the message's position in its conversation, or -1
+    int logMessage(const QString& from, const QString& to, const QString& text, qint64 sentAt);
+    void logGraphChange(int type, quint32 user, quint32 other, bool enabled);
+    void followFeaturedAuthors(const QString& username);
+
+    // Home timelines (fan-out on write, celebrities on read)
+    RankedPage rankFeed(quint32 viewer, const QByteArray& cursor, int pageSize, bool closeFriendsOnly);
+    void materializeTimeline(quint32 viewer);
+    void fanOut(const StoredPost& post, quint32 record);
+    
+    // Notifications (called while applying logged mutations)
+    void notify(int kind, quint32 recipient, quint32 actor, quint64 target, bool priority, qint64 at);
+    void notifyNewPost(const StoredPost& post);
+    bool isCloseFriendOf(quint32 user, quint32 other) const;
+    quint32 postAuthor(quint64 postId) const;
+
+    // Search index: built on the first query, then kept current as posts
+    // are created
+    void syncSearchIndex(bool build);
+
+    // Appends to the WAL; 0 when the log is closed or has failed
+    quint64 logMutation(int type, const QByteArray& payload);
+    
+    // Applies a logged mutation to the in-memory state (also used for replay);
+    // messageIndex receives a stored message's conversation position
+    void applyLogRecord(int type, quint64 sequence, const QByteArray& payload, int* messageIndex = nullptr);
+
+    // posts.dat access
+    bool openPostStore();
+    Post postFromRecord(quint64 recordIndex);
+
+    QThreadPool m_pool;
+    QThreadPool m_writer;   // One thread: mutations made on the GUI thread
+
+    // users.dat (thread-safe; the slow hash runs outside its locks)
+    QScopedPointer<CredentialStore> m_credentials;
+
+    // Opened once under the mutex, then only read
+    QMutex m_storeMutex;
+    QScopedPointer<PostStore> m_postStore;
+    QHash<quint32, bool> m_featuredAuthors;   // posts.dat authors -> has priority posts
+
+    // Author streams and timelines over posts.dat plus posts created since
+    // (kept in the WAL, numbered after the posts.dat records)
+    mutable QReadWriteLock m_feedLock;
+    QScopedPointer<FeedRanker> m_feedRanker;
+    QScopedPointer<TimelineStore> m_timelines;
+    QVector<StoredPost> m_createdPosts;
+    quint64 m_nextPostId = 1;
+    bool m_feedReady = false;
+
+    // Full-text index over the same records (taken before m_feedLock)
+    QReadWriteLock m_searchLock;
+    QScopedPointer<SearchIndex> m_searchIndex;
+    QVector<quint32> m_searchRecords;   // Document id -> record
+    int m_searchCreatedIndexed = 0;     // Created posts already indexed
+    bool m_searchReady = false;
+
+    // messages.dat, appended to as logged messages are applied
+    QMutex m_messageMutex;
+    QScopedPointer<MessageStore> m_messageStore;
+
+    // graph.dat follows and close friends, keyed by users.dat ids
+    mutable QReadWriteLock m_graphLock;
+    QScopedPointer<SocialGraph> m_graph;
+
+    // Stories from the last 24 hours (thread-safe; rebuilt from the WAL and
+    // swept on a timer)
+    QScopedPointer<StoryStore> m_stories;
+    QTimer* m_storySweeper = nullptr;
+
+    // Per-user notification lanes (thread-safe; rebuilt from the WAL)
+    QScopedPointer<NotificationQueue> m_notifications;
+
+    // Mutation log and the state recovered from it
+    QScopedPointer<WriteAheadLog> m_wal;
+    QAtomicInteger<int> m_walFailureReported;
+    bool m_replaying = false;
+    QMutex m_stateMutex;   // Guards the two tables below only
+    QHash<quint64, int> m_likesAdded;
+    QHash<QString, bool> m_closeFriendMode;
+};
+
+#endif // BACKENDSERVICE_H
@@ -0,0 +1,95 @@
+#ifndef ALLOCCOUNT_H
+#define ALLOCCOUNT_H
+
+// ============================================================================
+// ALLOCATION COUNTER
+// Counts heap allocations process-wide, on every thread, by interposing
+// the C allocator (malloc, calloc, realloc and the aligned variants);
+// operator new, polymorphic resources and Qt's containers all end up
+// there. glibc only; elsewhere allocationCountSupported() is false and
+// the count stays 0.
+//
+// Defines the allocator entry points: include it in exactly one
+// translation unit of a benchmark executable.
+// ============================================================================
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+namespace {
+
+std::atomic<unsigned long long> g_allocationCount{ 0 };
+
+} // namespace
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) noexcept
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* block = __libc_memalign(alignment, size);
+    if (!block) {
+        return ENOMEM;
+    }
+    *ptr = block;
+    return 0;
+}
+
+} // extern "C"
+
+inline bool allocationCountSupported() { return true; }
+
+#else
+
+inline bool allocationCountSupported() { return false; }
+
+#endif
+
+inline unsigned long long allocationCount()
+{
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+#endif // ALLOCCOUNT_H
@@ -0,0 +1,145 @@
+// ============================================================================
+// MESSAGE BUS LATENCY BENCHMARK
+// Load generator for the local message bus: many clients publish to each
+// other at a fixed aggregate rate; every delivery records publish-to-receive
+// latency on the monotonic clock. Prints delivered rate and p50/p99/max.
+//
+// The broker runs on its own thread unless --external is given, in which
+// case a separately started messagebroker process is used (started from
+// the same directory, so both sign with the same session.key).
+// Usage: bench_bus [clients] [messages/s] [seconds] [--external]
+// ============================================================================
+
+#include "../messagebroker.h"
+#include "../messagebus.h"
+#include "../credentialstore.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const char* const BenchServerName = "priority-social-bus-bench";
+const int TokenSeconds = 3600;
+const int PublishTickMs = 1;
+const int DrainMs = 1000;
+
+void waitFor(int timeoutMs, const std::function<bool()>& done)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+}
+
+double percentile(const std::vector<qint64>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t i = std::min(sorted.size() - 1, size_t(p * (sorted.size() - 1) + 0.5));
+    return sorted[i] / 1e3;   // Microseconds
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments().mid(1);
+    const bool external = args.removeAll("--external") > 0;
+    const int clientCount = qMax(2, args.size() > 0 ? args.at(0).toInt() : 200);
+    const int rate = args.size() > 1 ? args.at(1).toInt() : 5000;
+    const int seconds = args.size() > 2 ? args.at(2).toInt() : 5;
+    const QString serverName = external ? QString(MessageBus::DefaultServerName)
+                                        : QString(BenchServerName);
+
+    // Load clients subscribe with tokens signed like a login's
+    QByteArray sessionKey;
+    QString keyError;
+    if (!CredentialStore::loadSessionKey("users.dat", &sessionKey, &keyError)) {
+        std::printf("session key: %s\n", qPrintable(keyError));
+        return 1;
+    }
+    
+    // Broker on its own event loop, as if it were another process
+    QThread brokerThread;
+    MessageBroker* broker = nullptr;
+    if (!external) {
+        broker = new MessageBroker();
+        broker->moveToThread(&brokerThread);
+        QObject::connect(&brokerThread, &QThread::finished, broker, &QObject::deleteLater);
+        brokerThread.start();
+        bool listening = false;
+        QMetaObject::invokeMethod(broker, [&]() { listening = broker->listen(serverName, sessionKey); },
+                                  Qt::BlockingQueuedConnection);
+        if (!listening) {
+            std::printf("broker: %s\n", qPrintable(broker->errorString()));
+            return 1;
+        }
+    }
+
+    std::vector<qint64> latencies;
+    latencies.reserve(size_t(rate) * size_t(seconds));
+    std::vector<std::unique_ptr<MessageBusClient>> clients;
+    for (int i = 0; i < clientCount; ++i) {
+        clients.emplace_back(new MessageBusClient());
+        QObject::connect(clients.back().get(), &MessageBusClient::messageReceived,
+                         [&latencies](const BusMessage& message) {
+            latencies.push_back(MessageBus::monotonicNs() - message.publishedNs);
+        });
+        const QString username = QString("load_%1").arg(i);
+        const qint64 expiresAt = QDateTime::currentSecsSinceEpoch() + TokenSeconds;
+        clients.back()->start(username, CredentialStore::signSession(sessionKey, username, expiresAt),
+                              serverName);
+    }
+    waitFor(5000, [&]() {
+        return std::all_of(clients.begin(), clients.end(),
+                           [](const std::unique_ptr<MessageBusClient>& c) { return c->isConnected(); });
+    });
+    waitFor(200, []() { return false; });   // Let the broker register subscriptions
+
+    // Paced publishing: each tick sends whatever the target rate is owed
+    qint64 sent = 0;
+    const qint64 total = qint64(rate) * seconds;
+    QElapsedTimer clock;
+    clock.start();
+    QTimer publishTimer;
+    QObject::connect(&publishTimer, &QTimer::timeout, [&]() {
+        const qint64 due = std::min(total, clock.elapsed() * rate / 1000);
+        for (; sent < due; ++sent) {
+            const int from = int(sent % clientCount);
+            const int to = (from + 1) % clientCount;
+            clients[size_t(from)]->publish(QString("load_%1").arg(to), QStringLiteral("ping"));
+        }
+        if (sent >= total) {
+            publishTimer.stop();
+        }
+    });
+    publishTimer.start(PublishTickMs);
+
+    waitFor(seconds * 1000 + DrainMs, [&]() { return sent >= total && qint64(latencies.size()) >= total; });
+    const double elapsedSec = clock.elapsed() / 1000.0;
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("clients=%d target=%d msg/s duration=%ds broker=%s\n",
+                clientCount, rate, seconds, external ? "external" : "thread");
+    std::printf("sent %lld, delivered %zu (%.0f msg/s)\n",
+                sent, latencies.size(), latencies.size() / qMax(elapsedSec, 0.001));
+    std::printf("latency p50 %8.1f us  p99 %8.1f us  max %8.1f us\n",
+                percentile(latencies, 0.50), percentile(latencies, 0.99),
+                latencies.empty() ? 0.0 : latencies.back() / 1e3);
+
+    clients.clear();
+    brokerThread.quit();
+    brokerThread.wait();
+    return 0;
+}
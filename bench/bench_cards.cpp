@@ -0,0 +1,139 @@
+// ============================================================================
+// CARD BUILD BENCHMARK
+// Time to build and first-paint 1k feed cards and 1k message bubbles:
+//   inline QSS  - every widget gets its own setStyleSheet (old builders)
+//   app sheet   - widgets only carry object names; AppStyle::styleSheet()
+//                 is set once on the top-level window
+//   delegate    - PostCardDelegate paints cards with AppStyle::paintPalette()
+//
+// Runs headless: QT_QPA_PLATFORM defaults to "offscreen".
+// Usage: bench_cards [count]
+// ============================================================================
+
+#include "../appstyle.h"
+#include "../feedmodel.h"
+#include "../postcarddelegate.h"
+#include "benchcommon.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QScrollArea>
+#include <QStyleOptionViewItem>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+// Same widget tree as MainWindow::createMessageBubble
+QWidget* styledMessageBubble(const Message& msg)
+{
+    QWidget* bubbleWidget = new QWidget();
+    QHBoxLayout* layout = new QHBoxLayout(bubbleWidget);
+    layout->setContentsMargins(0, 5, 0, 5);
+    if (msg.isOutgoing) {
+        layout->addStretch();
+    }
+
+    QFrame* bubble = new QFrame();
+    bubble->setMaximumWidth(400);
+    bubble->setObjectName(msg.isOutgoing ? "outgoingBubble" : "incomingBubble");
+
+    QVBoxLayout* bubbleLayout = new QVBoxLayout(bubble);
+    bubbleLayout->setSpacing(5);
+    QLabel* senderLabel = new QLabel(msg.sender);
+    senderLabel->setObjectName("bubbleSender");
+    bubbleLayout->addWidget(senderLabel);
+    QLabel* contentLabel = new QLabel(msg.content);
+    contentLabel->setObjectName("bubbleContent");
+    contentLabel->setWordWrap(true);
+    bubbleLayout->addWidget(contentLabel);
+    QLabel* timeLabel = new QLabel(TimeFormatter::clock(msg.sentAt));
+    timeLabel->setObjectName("bubbleTime");
+    timeLabel->setAlignment(Qt::AlignRight);
+    bubbleLayout->addWidget(timeLabel);
+
+    layout->addWidget(bubble);
+    if (!msg.isOutgoing) {
+        layout->addStretch();
+    }
+    return bubbleWidget;
+}
+
+// Builds count widgets into a shown scroll area and waits for the first paint
+qint64 timeWidgetBuild(int count, const QString& windowSheet,
+                       const std::function<QWidget*(int)>& build)
+{
+    QScrollArea area;
+    area.setStyleSheet(windowSheet);
+    area.resize(600, 900);
+    area.setWidgetResizable(true);
+    area.show();
+    QApplication::processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+    QWidget* container = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    for (int i = 0; i < count; ++i) {
+        layout->addWidget(build(i));
+    }
+    area.setWidget(container);
+    QApplication::processEvents();
+    return timer.elapsed();
+}
+
+qint64 timeDelegatePaint(const QVector<Post>& posts)
+{
+    FeedModel model;
+    model.setPosts(posts);
+    PostCardDelegate delegate;
+
+    QImage target(600, PostCardDelegate::CardHeight, QImage::Format_ARGB32_Premultiplied);
+    QStyleOptionViewItem option;
+    option.rect = target.rect();
+    option.font = QApplication::font();
+
+    QElapsedTimer timer;
+    timer.start();
+    QPainter painter(&target);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        delegate.paint(&painter, option, model.index(row));
+    }
+    painter.end();
+    return timer.elapsed();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    const int count = argc > 1 ? QString(argv[1]).toInt() : 1000;
+    const QVector<Post> posts = samplePosts(count);
+    const QVector<Message> messages = sampleMessages(count);
+
+    const qint64 legacyCards = timeWidgetBuild(count, QString(),
+        [&](int i) { return legacyPostCard(posts.at(i)); });
+    const qint64 legacyBubbles = timeWidgetBuild(count, QString(),
+        [&](int i) { return legacyMessageBubble(messages.at(i)); });
+    const qint64 styledBubbles = timeWidgetBuild(count, AppStyle::styleSheet(),
+        [&](int i) { return styledMessageBubble(messages.at(i)); });
+
+    QPixmapCache::clear();
+    const qint64 delegateCold = timeDelegatePaint(posts);
+    const qint64 delegateWarm = timeDelegatePaint(posts);
+
+    std::printf("items=%d\n", count);
+    std::printf("post cards, inline QSS widgets:   %6lld ms\n", legacyCards);
+    std::printf("post cards, delegate (cold cache): %6lld ms\n", delegateCold);
+    std::printf("post cards, delegate (warm cache): %6lld ms\n", delegateWarm);
+    std::printf("bubbles, inline QSS widgets:      %6lld ms\n", legacyBubbles);
+    std::printf("bubbles, app style sheet:         %6lld ms\n", styledBubbles);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// ============================================================================
+// FEED ALLOCATION BENCHMARK
+// Heap allocations (malloc calls, every thread) per feed load after login:
+//   backend page - requestFeedPage to feedPageLoaded: graph copy, ranking,
+//                  post records, the queued signal
+//   model fill   - FeedModel::setPosts with that page (a reload)
+// measured with the per-thread ScratchArena off (ranking buffers on the
+// heap) and on. The first loads are warm-up: they materialize the
+// viewer's timeline and size the arenas.
+//
+// Needs glibc to count; stores are created in a temporary directory.
+// Usage: bench_feedalloc [--json path]
+// ============================================================================
+
+#include "alloccount.h"
+#include "../backendservice.h"
+#include "../feedmodel.h"
+#include "../scratcharena.h"
+#include "benchcommon.h"
+#include <QApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <cstdio>
+
+namespace {
+
+const int PageSize = 20;
+const int WarmupLoads = 5;
+const int MeasuredLoads = 50;
+
+FeedPage loadFeed(BackendService& backend, const QString& username)
+{
+    FeedPage page{ {}, QByteArray(), true };
+    QEventLoop loop;
+    QObject::connect(&backend, &BackendService::feedPageLoaded, &loop, [&](const FeedPage& loaded) {
+        page = loaded;
+        loop.quit();
+    });
+    backend.requestFeedPage(username, QByteArray(), PageSize, 0);
+    loop.exec();
+    return page;
+}
+
+struct Counts {
+    double backend = 0;
+    double model = 0;
+    int posts = 0;
+};
+
+Counts measure(BackendService& backend, FeedModel& model, const QString& username)
+{
+    for (int i = 0; i < WarmupLoads; ++i) {
+        model.setPosts(loadFeed(backend, username).posts);
+    }
+
+    unsigned long long backendTotal = 0;
+    unsigned long long modelTotal = 0;
+    Counts counts;
+    for (int i = 0; i < MeasuredLoads; ++i) {
+        const unsigned long long start = allocationCount();
+        const FeedPage page = loadFeed(backend, username);
+        const unsigned long long loaded = allocationCount();
+        model.setPosts(page.posts);
+        modelTotal += allocationCount() - loaded;
+        backendTotal += loaded - start;
+        counts.posts = page.posts.size();
+    }
+    counts.backend = double(backendTotal) / MeasuredLoads;
+    counts.model = double(modelTotal) / MeasuredLoads;
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QString jsonPath;
+    const QStringList args = app.arguments();
+    const int jsonArg = args.indexOf("--json");
+    if (jsonArg >= 0 && jsonArg + 1 < args.size()) {
+        jsonPath = args.at(jsonArg + 1);
+    }
+
+    if (!allocationCountSupported()) {
+        std::printf("allocation counting needs glibc; nothing measured\n");
+        return 0;
+    }
+
+    QTemporaryDir dir;
+    QDir::setCurrent(dir.path());
+
+    // Sign-up registers the user and follows the featured authors
+    const QString username = "bench_user";
+    BackendService backend;
+    {
+        QEventLoop loop;
+        QObject::connect(&backend, &BackendService::authenticated, &loop, &QEventLoop::quit);
+        backend.authenticate(username, "bench_password", true);
+        loop.exec();
+    }
+
+    FeedModel model;
+    BenchReport report("feedalloc");
+    for (bool arena : { false, true }) {
+        ScratchArena::setEnabled(arena);
+        const Counts counts = measure(backend, model, username);
+        const QString mode = arena ? "scratch arena" : "heap";
+        const QJsonObject params{ { "posts", counts.posts }, { "scratchArena", arena } };
+        report.add(QString("backend page (%1)").arg(mode), counts.backend, "mallocs/load", params);
+        report.add(QString("model fill (%1)").arg(mode), counts.model, "mallocs/load", params);
+    }
+
+    if (!jsonPath.isEmpty() && !report.write(jsonPath)) {
+        return 1;
+    }
+    return 0;
+}
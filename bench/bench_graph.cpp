@@ -0,0 +1,120 @@
+// ============================================================================
+// SOCIAL GRAPH BENCHMARK
+// Builds a random follow graph in graph.dat (saving every batch so the
+// overlay stays small), reopens it mapped and measures:
+//   size        - bytes on disk / mapped, and bytes per edge
+//   isFollowing - binary search in one CSR row
+//   degree      - follower + following counts
+//   filter      - close-friend check per feed post, sorted vs bitset sets
+//
+// Usage: bench_graph [users] [edges] [closeFriends]
+// ============================================================================
+
+#include "../socialgraph.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <cstdio>
+
+namespace {
+
+const int BatchEdges = 1000000;
+const int Lookups = 2000000;
+
+double nsPer(qint64 elapsedNs, int count)
+{
+    return double(elapsedNs) / qMax(1, count);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const quint32 users = argc > 1 ? QString(argv[1]).toUInt() : 1000000;
+    const qint64 edges = argc > 2 ? QString(argv[2]).toLongLong() : 10000000;
+    const int closeFriends = argc > 3 ? QString(argv[3]).toInt() : 50000;
+
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/graph.dat";
+    QRandomGenerator random(42);
+
+    std::printf("users=%u edges=%lld closeFriends=%d\n", users, edges, closeFriends);
+
+    // Build
+    QElapsedTimer timer;
+    timer.start();
+    {
+        SocialGraph graph;
+        graph.open(path);
+        qint64 added = 0;
+        while (added < edges) {
+            const qint64 batchEnd = qMin(edges, added + BatchEdges);
+            while (added < batchEnd) {
+                if (graph.follow(random.bounded(users), random.bounded(users))) {
+                    ++added;
+                }
+            }
+            if (!graph.save(path)) {
+                std::printf("save failed: %s\n", qPrintable(graph.errorString()));
+                return 1;
+            }
+        }
+
+        // User 0 gets a bitset (dense) close-friend set, user 1 a sorted one
+        for (int i = 0; i < closeFriends; ++i) {
+            graph.setCloseFriend(0, random.bounded(users), true);
+        }
+        for (int i = 0; i < 500; ++i) {
+            graph.setCloseFriend(1, random.bounded(users), true);
+        }
+        graph.save(path);
+    }
+    std::printf("build:        %8.1f s\n", timer.elapsed() / 1000.0);
+
+    SocialGraph graph;
+    timer.restart();
+    if (!graph.open(path)) {
+        std::printf("open failed: %s\n", qPrintable(graph.errorString()));
+        return 1;
+    }
+    const qint64 bytes = QFileInfo(path).size();
+    std::printf("open:         %8.3f ms\n", timer.nsecsElapsed() / 1e6);
+    std::printf("size:         %8.1f MB  (%.1f bytes/edge, %llu edges)\n",
+                bytes / (1024.0 * 1024.0), double(bytes) / qMax<quint64>(1, graph.edgeCount()),
+                graph.edgeCount());
+
+    // Queries (random ids, so mostly cold rows)
+    QVector<quint32> ids(2 * Lookups);
+    for (quint32& id : ids) {
+        id = random.bounded(users);
+    }
+
+    quint64 sink = 0;
+    timer.restart();
+    for (int i = 0; i < Lookups; ++i) {
+        sink += graph.isFollowing(ids[2 * i], ids[2 * i + 1]);
+    }
+    std::printf("isFollowing:  %8.1f ns\n", nsPer(timer.nsecsElapsed(), Lookups));
+
+    timer.restart();
+    for (int i = 0; i < Lookups; ++i) {
+        sink += quint64(graph.followerCount(ids[i]) + graph.followingCount(ids[i]));
+    }
+    std::printf("degree:       %8.1f ns\n", nsPer(timer.nsecsElapsed(), Lookups));
+
+    for (quint32 viewer : { 1u, 0u }) {
+        timer.restart();
+        for (int i = 0; i < Lookups; ++i) {
+            sink += graph.isCloseFriend(viewer, ids[i]);
+        }
+        std::printf("filter (%5d friends): %6.1f ns/post\n",
+                    graph.closeFriendCount(viewer), nsPer(timer.nsecsElapsed(), Lookups));
+    }
+
+    std::printf("(checksum %llu)\n", sink);
+    return 0;
+}
@@ -0,0 +1,97 @@
+// ============================================================================
+// LIKE THROUGHPUT BENCHMARK
+// Likes per second on a 5k-post feed:
+//   before - widget cards in a QVBoxLayout; a like rebuilds the card and
+//            swaps it in with replaceWidget (the old MainWindow::likePost)
+//   after  - FeedModel + PostCardDelegate; a like updates one counter role
+//
+// Runs headless: QT_QPA_PLATFORM defaults to "offscreen".
+// Usage: bench_likes [posts] [likes]
+// ============================================================================
+
+#include "../feedmodel.h"
+#include "../postcarddelegate.h"
+#include "benchcommon.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QListView>
+#include <QScrollArea>
+#include <QVBoxLayout>
+#include <cstdio>
+
+namespace {
+
+double benchLegacy(const QVector<Post>& source, int likes)
+{
+    QVector<Post> posts = source;
+    QScrollArea area;
+    area.resize(600, 900);
+    area.setWidgetResizable(true);
+    QWidget* container = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    for (const Post& post : posts) {
+        layout->addWidget(legacyPostCard(post));
+    }
+    area.setWidget(container);
+    area.show();
+    QApplication::processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < likes; ++i) {
+        const int row = i % 3;   // Cards on screen
+        posts[row].likes++;
+        QWidget* oldCard = layout->itemAt(row)->widget();
+        QWidget* newCard = legacyPostCard(posts[row]);
+        layout->replaceWidget(oldCard, newCard);
+        delete oldCard;
+        QApplication::processEvents();
+    }
+    return likes * 1000.0 / qMax<qint64>(1, timer.elapsed());
+}
+
+double benchModelView(const QVector<Post>& posts, int likes)
+{
+    FeedModel model;
+    model.setPosts(posts);
+    PostCardDelegate delegate;
+    QListView view;
+    view.resize(600, 900);
+    view.setModel(&model);
+    view.setItemDelegate(&delegate);
+    view.setUniformItemSizes(true);
+    view.setSpacing(10);
+    view.show();
+    QApplication::processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < likes; ++i) {
+        model.incrementLikes(i % 3);
+        QApplication::processEvents();
+    }
+    return likes * 1000.0 / qMax<qint64>(1, timer.elapsed());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    const int postCount = argc > 1 ? QString(argv[1]).toInt() : 5000;
+    const int likeCount = argc > 2 ? QString(argv[2]).toInt() : 500;
+    const QVector<Post> posts = samplePosts(postCount);
+
+    const double before = benchLegacy(posts, likeCount);
+    const double after = benchModelView(posts, likeCount);
+
+    std::printf("posts=%d likes=%d\n", postCount, likeCount);
+    std::printf("before (rebuild card):   %10.1f likes/s\n", before);
+    std::printf("after  (in-place update): %10.1f likes/s\n", after);
+    std::printf("speedup: %.1fx\n", after / qMax(before, 0.001));
+    return 0;
+}
@@ -0,0 +1,91 @@
+// ============================================================================
+// LOGIN THROUGHPUT BENCHMARK
+// Logins per second against a users.dat credential store, run on a worker
+// thread pool the way BackendService::authenticate does:
+//   cold - first login per user pays the full PBKDF2 hash
+//   warm - repeat logins hit the verified-credential cache
+// Each phase runs once on a single thread and once on all cores to show the
+// slow hash does not serialize.
+//
+// Usage: bench_login [users] [logins] [iterations]
+// ============================================================================
+
+#include "../credentialstore.h"
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+#include <cstdio>
+
+namespace {
+
+double runLogins(CredentialStore& store, int users, int logins, int threads)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QAtomicInt failures;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < logins; ++i) {
+        pool.start([&store, &failures, i, users]() {
+            const int user = i % users;
+            if (!store.verify(QString("user_%1").arg(user), QString("password-%1").arg(user))) {
+                failures.fetchAndAddRelaxed(1);
+            }
+        });
+    }
+    pool.waitForDone();
+    const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+
+    if (failures.loadRelaxed() != 0) {
+        std::printf("  %d logins failed\n", failures.loadRelaxed());
+    }
+    return logins * 1000.0 / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int users = argc > 1 ? QString(argv[1]).toInt() : 200;
+    const int logins = argc > 2 ? QString(argv[2]).toInt() : 400;
+    CredentialStore::Options options;
+    if (argc > 3) {
+        options.iterations = QString(argv[3]).toInt();
+    }
+    const int cores = QThread::idealThreadCount();
+
+    QTemporaryDir dir;
+    const QString path = dir.path() + "/users.dat";
+    {
+        CredentialStore seed;
+        if (!seed.open(path, options)) {
+            std::printf("open failed: %s\n", qPrintable(seed.errorString()));
+            return 1;
+        }
+        for (int i = 0; i < users; ++i) {
+            seed.registerUser(QString("user_%1").arg(i), QString("password-%1").arg(i));
+        }
+    }
+
+    std::printf("users=%d logins=%d iterations=%d cores=%d\n",
+                users, logins, options.iterations, cores);
+
+    // Fresh store per thread count so the cold runs really are cold
+    for (int threads : { 1, cores }) {
+        CredentialStore store;
+        store.open(path, options);
+        const double cold = runLogins(store, users, qMin(logins, users), threads);
+        const quint64 slowHashes = store.slowHashCount();
+        const double warm = runLogins(store, users, logins, threads);
+        std::printf("%2d thread(s): cold %9.1f logins/s   warm %9.1f logins/s   "
+                    "(slow hashes: %llu cold, %llu warm)\n",
+                    threads, cold, warm, slowHashes, store.slowHashCount() - slowHashes);
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+// ============================================================================
+// MAINWINDOW BENCHMARK
+// The MainWindow hot paths on a real window, driven through its slots the
+// way backend results and clicks reach it:
+//   post cards     - cards rendered per second by PostCardDelegate (what
+//                    createPostCard became), cold and warm body cache
+//   message bubbles - bubbles built per second by createMessageBubble,
+//                    through onMessagesLoaded
+//   feed fill      - first feed page after login (onFeedPageLoaded) with
+//                    100 / 1k / 10k posts, up to the painted frame
+//   like           - likePost latency, click to repainted row
+//   messages reload - showMessages with a fresh 200-message page
+//
+// Runs headless: QT_QPA_PLATFORM defaults to "offscreen". The window's
+// stores are created in a temporary directory.
+// Usage: bench_mainwindow [--json path]
+// ============================================================================
+
+#include "../feedmodel.h"
+#include "../mainwindow.h"
+#include "../postcarddelegate.h"
+#include "benchcommon.h"
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QStyleOptionViewItem>
+#include <QTemporaryDir>
+#include <algorithm>
+
+namespace {
+
+const int CardCount = 1000;
+const int BubbleCount = 1000;
+const int LikeCount = 1000;
+const int ReloadMessages = 200;
+const int Repeats = 5;
+
+double median(QVector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples.isEmpty() ? 0.0 : samples.at(samples.size() / 2);
+}
+
+void invoke(MainWindow& window, const char* slot)
+{
+    QMetaObject::invokeMethod(&window, slot, Qt::DirectConnection);
+}
+
+// A page as the backend would deliver it, numbered from firstIndex
+MessagePage messagePage(int firstIndex, int count)
+{
+    MessagePage page;
+    page.partner = "Alice";
+    page.messages = sampleMessages(count);
+    for (int i = 0; i < page.messages.size(); ++i) {
+        page.messages[i].index = firstIndex + i;
+    }
+    page.firstIndex = firstIndex;
+    page.total = firstIndex + count;
+    return page;
+}
+
+// Shown and idle: every page built, first frame painted
+void settle(MainWindow& window)
+{
+    window.resize(1000, 800);
+    window.show();
+    for (int i = 0; i < 10; ++i) {
+        QApplication::processEvents();
+    }
+}
+
+double renderCards(int count)
+{
+    FeedModel model;
+    model.setPosts(samplePosts(count));
+    PostCardDelegate delegate;
+    QImage target(600, PostCardDelegate::CardHeight, QImage::Format_ARGB32_Premultiplied);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int row = 0; row < count; ++row) {
+        QPainter painter(&target);
+        QStyleOptionViewItem option;
+        option.rect = target.rect();
+        delegate.paint(&painter, option, model.index(row));
+    }
+    return timer.nsecsElapsed() / 1e9;
+}
+
+double feedFill(int posts)
+{
+    QVector<double> samples;
+    for (int r = 0; r < Repeats; ++r) {
+        MainWindow window;
+        settle(window);
+        invoke(window, "showFeed");
+
+        FeedPage page{ samplePosts(posts), QByteArray(), true };
+        QElapsedTimer timer;
+        timer.start();
+        QMetaObject::invokeMethod(&window, "onFeedPageLoaded", Qt::DirectConnection, Q_ARG(FeedPage, page));
+        QApplication::processEvents();
+        samples.append(timer.nsecsElapsed() / 1e6);
+    }
+    return median(samples);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QString jsonPath;
+    const QStringList args = app.arguments();
+    const int jsonArg = args.indexOf("--json");
+    if (jsonArg >= 0 && jsonArg + 1 < args.size()) {
+        jsonPath = args.at(jsonArg + 1);
+    }
+
+    // posts.dat, users.dat and the WAL land here, not in the caller's cwd
+    QTemporaryDir dir;
+    QDir::setCurrent(dir.path());
+
+    BenchReport report("mainwindow");
+
+    // Post cards
+    QPixmapCache::clear();
+    const double coldSeconds = renderCards(CardCount);
+    const double warmSeconds = renderCards(CardCount);
+    report.add("post cards (cold cache)", CardCount / coldSeconds, "cards/s", { { "cards", CardCount } });
+    report.add("post cards (warm cache)", CardCount / warmSeconds, "cards/s", { { "cards", CardCount } });
+
+    MainWindow window;
+    settle(window);
+
+    // Message bubbles: each page starts past the last, so the view is rebuilt
+    invoke(window, "showMessages");
+    QVector<double> bubbleSamples;
+    for (int r = 0; r < Repeats; ++r) {
+        const MessagePage page = messagePage((r + 1) * (BubbleCount + 1), BubbleCount);
+        QElapsedTimer timer;
+        timer.start();
+        QMetaObject::invokeMethod(&window, "onMessagesLoaded", Qt::DirectConnection, Q_ARG(MessagePage, page));
+        QApplication::processEvents();
+        bubbleSamples.append(BubbleCount / (timer.nsecsElapsed() / 1e9));
+    }
+    report.add("message bubbles", median(bubbleSamples), "bubbles/s", { { "bubbles", BubbleCount } });
+
+    // Feed population after login
+    for (int posts : { 100, 1000, 10000 }) {
+        report.add(QString("feed fill (%1 posts)").arg(posts), feedFill(posts), "ms", { { "posts", posts } });
+    }
+
+    // Likes on a 1k-post feed
+    invoke(window, "showFeed");
+    const FeedPage feed{ samplePosts(1000), QByteArray(), true };
+    QMetaObject::invokeMethod(&window, "onFeedPageLoaded", Qt::DirectConnection, Q_ARG(FeedPage, feed));
+    QApplication::processEvents();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < LikeCount; ++i) {
+        QMetaObject::invokeMethod(&window, "likePost", Qt::DirectConnection, Q_ARG(int, i % 10));
+        QApplication::processEvents();
+    }
+    report.add("like latency", timer.nsecsElapsed() / 1e3 / LikeCount, "us", { { "likes", LikeCount } });
+
+    // Messages page reload
+    QVector<double> reloadSamples;
+    int nextIndex = (Repeats + 1) * (BubbleCount + 1);
+    for (int r = 0; r < Repeats; ++r) {
+        invoke(window, "showFeed");
+        QApplication::processEvents();
+
+        const MessagePage page = messagePage(nextIndex, ReloadMessages);
+        nextIndex += ReloadMessages + 1;
+        timer.restart();
+        invoke(window, "showMessages");
+        QMetaObject::invokeMethod(&window, "onMessagesLoaded", Qt::DirectConnection, Q_ARG(MessagePage, page));
+        QApplication::processEvents();
+        reloadSamples.append(timer.nsecsElapsed() / 1e6);
+    }
+    report.add("messages reload", median(reloadSamples), "ms", { { "messages", ReloadMessages } });
+
+    if (!jsonPath.isEmpty() && !report.write(jsonPath)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// ============================================================================
+// OPEN CONVERSATION BENCHMARK
+// Time to open a chat of 50 vs 50k messages:
+//   before - every message turned into a bubble (the old onMessagesLoaded)
+//   after  - MessageStore reads the newest page; only its bubbles are built
+// The store is opened (index rebuilt) once up front, as BackendService does.
+//
+// Runs headless: QT_QPA_PLATFORM defaults to "offscreen".
+// Usage: bench_messages [small] [large]
+// ============================================================================
+
+#include "../messagestore.h"
+#include "benchcommon.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QScrollArea>
+#include <QTemporaryDir>
+#include <cstdio>
+
+namespace {
+
+const int PageSize = 50;
+
+struct OpenTimes {
+    qint64 rebuildMs = 0;
+    qint64 pagedMs = 0;
+};
+
+qint64 showBubbles(const QVector<Message>& messages)
+{
+    QScrollArea area;
+    area.resize(600, 900);
+    area.setWidgetResizable(true);
+    area.show();
+    QApplication::processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+    QWidget* container = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    for (const Message& msg : messages) {
+        layout->addWidget(legacyMessageBubble(msg));
+    }
+    area.setWidget(container);
+    QApplication::processEvents();
+    return timer.elapsed();
+}
+
+OpenTimes benchConversation(const QString& dir, int count)
+{
+    MessageStore store;
+    if (!store.open(dir + QString("/messages_%1.dat").arg(count))) {
+        std::printf("open failed: %s\n", qPrintable(store.errorString()));
+        return OpenTimes();
+    }
+    for (int i = 0; i < count; ++i) {
+        const bool outgoing = (i % 2 == 1);
+        store.append({ 0, 1700000000 + i, outgoing ? "me" : "Alice", outgoing ? "Alice" : "me",
+                       QString("Message %1: the panda login screen is so cute!").arg(i) });
+    }
+
+    OpenTimes times;
+    times.rebuildMs = showBubbles(sampleMessages(count));
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<Message> page;
+    for (const StoredMessage& stored : store.conversation("me", "Alice", PageSize)) {
+        page.append({ stored.from, stored.text, QString(), stored.from == "me" });
+    }
+    times.pagedMs = timer.elapsed() + showBubbles(page);
+    return times;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    const int small = argc > 1 ? QString(argv[1]).toInt() : 50;
+    const int large = argc > 2 ? QString(argv[2]).toInt() : 50000;
+
+    QTemporaryDir dir;
+    const OpenTimes smallTimes = benchConversation(dir.path(), small);
+    const OpenTimes largeTimes = benchConversation(dir.path(), large);
+
+    std::printf("page=%d\n", PageSize);
+    std::printf("%6d messages: rebuild all %7lld ms   newest page %5lld ms\n",
+                small, smallTimes.rebuildMs, smallTimes.pagedMs);
+    std::printf("%6d messages: rebuild all %7lld ms   newest page %5lld ms\n",
+                large, largeTimes.rebuildMs, largeTimes.pagedMs);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// ============================================================================
+// POST TABLE BENCHMARK
+// Memory per post and scan speed on a large feed:
+//   before - QVector<Post>, three heap-allocated QStrings per post
+//   after  - PostTable: numeric columns, interned authors, one text arena
+// Scans are the shapes ranking and filtering use: counters of priority
+// posts, and every post by one author.
+//
+// QString heap blocks are estimated (header plus UTF-16 payload, rounded
+// to the allocator's 16 bytes); PostTable counts its own capacity.
+// Usage: bench_posttable [posts] [rounds]
+// ============================================================================
+
+#include "../posttable.h"
+#include "benchcommon.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace {
+
+qint64 stringBytes(const QString& text)
+{
+    if (text.isEmpty()) {
+        return 0;   // Shared null
+    }
+    const qint64 block = 24 + qint64(text.capacity() + 1) * qint64(sizeof(QChar));
+    return (block + 15) / 16 * 16;
+}
+
+qint64 structBytes(const QVector<Post>& posts)
+{
+    qint64 bytes = qint64(posts.capacity()) * qint64(sizeof(Post));
+    for (const Post& post : posts) {
+        bytes += stringBytes(post.username) + stringBytes(post.content) + stringBytes(post.media);
+    }
+    return bytes;
+}
+
+template <typename Scan>
+double timeScans(int rounds, Scan scan, qint64* sink)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < rounds; ++r) {
+        *sink += scan();
+    }
+    return timer.nsecsElapsed() / 1e6 / rounds;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int postCount = argc > 1 ? QString(argv[1]).toInt() : 100000;
+    const int rounds = argc > 2 ? QString(argv[2]).toInt() : 50;
+    const QVector<Post> posts = samplePosts(postCount);
+
+    PostTable table;
+    table.append(posts);
+
+    const QString author = posts.isEmpty() ? QString() : posts.first().username;
+    qint64 sink = 0;
+
+    // Likes and comments on priority posts
+    const double structPriority = timeScans(rounds, [&]() {
+        qint64 total = 0;
+        for (const Post& post : posts) {
+            if (post.isPriority) {
+                total += post.likes + post.comments;
+            }
+        }
+        return total;
+    }, &sink);
+    const double tablePriority = timeScans(rounds, [&]() {
+        qint64 total = 0;
+        for (int row = 0; row < table.size(); ++row) {
+            if (table.isPriority(row)) {
+                total += table.likes(row) + table.comments(row);
+            }
+        }
+        return total;
+    }, &sink);
+
+    // Posts by one author: string compares against an interned id
+    const double structAuthor = timeScans(rounds, [&]() {
+        qint64 found = 0;
+        for (const Post& post : posts) {
+            found += post.username == author;
+        }
+        return found;
+    }, &sink);
+    const double tableAuthor = timeScans(rounds, [&]() {
+        const quint32 authorId = table.isEmpty() ? 0 : table.authorId(0);
+        qint64 found = 0;
+        for (int row = 0; row < table.size(); ++row) {
+            found += table.authorId(row) == authorId;
+        }
+        return found;
+    }, &sink);
+
+    const double structPerPost = double(structBytes(posts)) / qMax(1, postCount);
+    const double tablePerPost = double(table.memoryUsage()) / qMax(1, postCount);
+
+    std::printf("posts=%d rounds=%d (checksum %lld)\n", postCount, rounds, static_cast<long long>(sink));
+    std::printf("%-22s %12s %12s\n", "", "QVector<Post>", "PostTable");
+    std::printf("%-22s %10.1f B %10.1f B   %.1fx smaller\n", "memory per post", structPerPost, tablePerPost,
+                structPerPost / qMax(tablePerPost, 0.001));
+    std::printf("%-22s %9.3f ms %9.3f ms   %.1fx\n", "priority counters scan", structPriority, tablePriority,
+                structPriority / qMax(tablePriority, 0.0001));
+    std::printf("%-22s %9.3f ms %9.3f ms   %.1fx\n", "author filter scan", structAuthor, tableAuthor,
+                structAuthor / qMax(tableAuthor, 0.0001));
+    return 0;
+}
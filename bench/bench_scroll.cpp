@@ -0,0 +1,119 @@
+// ============================================================================
+// SCROLL FRAME TIME BENCHMARK
+// Average and worst frame time while scrolling a feed of shadowed cards:
+//   before - widget cards, each with its own QGraphicsDropShadowEffect
+//   after  - PostCardDelegate with the cached nine-patch shadow
+// Each frame moves the scroll bar and repaints the viewport synchronously.
+// Target: under 8 ms per frame.
+//
+// Runs headless: QT_QPA_PLATFORM defaults to "offscreen".
+// Usage: bench_scroll [posts] [frames]
+// ============================================================================
+
+#include "../feedmodel.h"
+#include "../postcarddelegate.h"
+#include "benchcommon.h"
+#include <QAbstractScrollArea>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QListView>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const int ScrollStep = 40;   // Pixels per frame (fast flick)
+
+struct FrameStats {
+    double averageMs = 0;
+    double worstMs = 0;
+};
+
+FrameStats scrollFrames(QAbstractScrollArea* area, int frames)
+{
+    QScrollBar* bar = area->verticalScrollBar();
+    QVector<qint64> times;
+    times.reserve(frames);
+    QElapsedTimer timer;
+    for (int i = 0; i < frames; ++i) {
+        timer.start();
+        int next = bar->value() + ScrollStep;
+        if (next > bar->maximum()) {
+            next = 0;
+        }
+        bar->setValue(next);
+        area->viewport()->repaint();
+        times.append(timer.nsecsElapsed());
+    }
+
+    FrameStats stats;
+    if (!times.isEmpty()) {
+        qint64 total = 0;
+        for (qint64 t : times) {
+            total += t;
+        }
+        stats.averageMs = total / 1e6 / times.size();
+        stats.worstMs = *std::max_element(times.begin(), times.end()) / 1e6;
+    }
+    return stats;
+}
+
+FrameStats benchLegacy(const QVector<Post>& posts, int frames)
+{
+    QScrollArea area;
+    area.resize(600, 900);
+    area.setWidgetResizable(true);
+    QWidget* container = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(container);
+    for (const Post& post : posts) {
+        layout->addWidget(legacyPostCard(post));
+    }
+    area.setWidget(container);
+    area.show();
+    QApplication::processEvents();
+    return scrollFrames(&area, frames);
+}
+
+FrameStats benchDelegate(const QVector<Post>& posts, int frames)
+{
+    FeedModel model;
+    model.setPosts(posts);
+    PostCardDelegate delegate;
+    QListView view;
+    view.resize(600, 900);
+    view.setModel(&model);
+    view.setItemDelegate(&delegate);
+    view.setUniformItemSizes(true);
+    view.setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    view.setSpacing(10);
+    view.show();
+    QApplication::processEvents();
+    return scrollFrames(&view, frames);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    const int postCount = argc > 1 ? QString(argv[1]).toInt() : 500;
+    const int frameCount = argc > 2 ? QString(argv[2]).toInt() : 300;
+    const QVector<Post> posts = samplePosts(postCount);
+
+    const FrameStats before = benchLegacy(posts, frameCount);
+    const FrameStats after = benchDelegate(posts, frameCount);
+
+    std::printf("posts=%d frames=%d step=%dpx\n", postCount, frameCount, ScrollStep);
+    std::printf("before (drop shadow effects): avg %7.2f ms  worst %7.2f ms\n",
+                before.averageMs, before.worstMs);
+    std::printf("after  (nine-patch shadows):  avg %7.2f ms  worst %7.2f ms\n",
+                after.averageMs, after.worstMs);
+    return 0;
+}
@@ -0,0 +1,153 @@
+// ============================================================================
+// SEARCH BENCHMARK
+// Indexes synthetic posts (words drawn from a skewed vocabulary, so a few
+// terms are very common and most are rare) and measures:
+//   build   - time to index every post, and posting bytes per post
+//   query   - µs per query for common, rare, two-word AND and prefix
+//             queries, against a linear scan over the post text that stops
+//             once it has the same number of newest matches
+//
+// Usage: bench_search [posts] [vocabulary] [limit]
+// ============================================================================
+
+#include "../searchindex.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const int WordsPerPost = 12;
+const int QueryRepeats = 200;
+
+struct Query {
+    const char* name;
+    QString text;
+};
+
+QString randomWord(QRandomGenerator& random)
+{
+    const int length = 3 + random.bounded(6);
+    QString word;
+    for (int i = 0; i < length; ++i) {
+        word.append(QChar('a' + random.bounded(26)));
+    }
+    return word;
+}
+
+// Log-uniform rank: rank r is drawn with probability ~1/r
+int skewedRank(QRandomGenerator& random, int vocabulary)
+{
+    return qMin(vocabulary - 1, int(std::pow(double(vocabulary), random.generateDouble())) - 1);
+}
+
+// Newest posts containing every word (case-insensitive substring)
+int linearScan(const QVector<QString>& contents, const QStringList& words, int limit)
+{
+    int hits = 0;
+    for (int i = contents.size() - 1; i >= 0 && hits < limit; --i) {
+        bool all = true;
+        for (const QString& word : words) {
+            if (!contents.at(i).contains(word, Qt::CaseInsensitive)) {
+                all = false;
+                break;
+            }
+        }
+        if (all) {
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int posts = argc > 1 ? QString(argv[1]).toInt() : 1000000;
+    const int vocabularySize = argc > 2 ? QString(argv[2]).toInt() : 50000;
+    const int limit = argc > 3 ? QString(argv[3]).toInt() : 50;
+
+    QRandomGenerator random(42);
+    QVector<QString> vocabulary;
+    vocabulary.reserve(vocabularySize);
+    for (int i = 0; i < vocabularySize; ++i) {
+        vocabulary.append(randomWord(random));
+    }
+
+    QVector<QString> contents;
+    QVector<QString> authors;
+    contents.reserve(posts);
+    authors.reserve(posts);
+    for (int i = 0; i < posts; ++i) {
+        QStringList words;
+        for (int w = 0; w < WordsPerPost; ++w) {
+            words.append(vocabulary.at(skewedRank(random, vocabularySize)));
+        }
+        contents.append(words.join(' '));
+        authors.append(QString("user_%1").arg(random.bounded(10000)));
+    }
+
+    std::printf("posts=%d vocabulary=%d limit=%d\n", posts, vocabularySize, limit);
+
+    // Build
+    SearchIndex index;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < posts; ++i) {
+        index.addDocument(authors.at(i), contents.at(i));
+    }
+    const qint64 buildMs = timer.elapsed();
+    std::printf("build: %lld ms, %d terms, %.1f MB postings (%.1f bytes/post)\n",
+                buildMs, index.termCount(), index.postingBytes() / 1e6,
+                double(index.postingBytes()) / qMax(1, posts));
+
+    const QString common = vocabulary.at(1);
+    const QString rare = vocabulary.at(vocabularySize / 2);
+    const QString middle = vocabulary.at(200);
+    const QVector<Query> queries = {
+        { "common term", common + ' ' },
+        { "rare term", rare + ' ' },
+        { "common AND middle", common + ' ' + middle + ' ' },
+        { "common AND rare", common + ' ' + rare + ' ' },
+        { "prefix (2 chars)", middle.left(2) },
+        { "prefix (3 chars)", middle.left(3) },
+        { "term + prefix", common + ' ' + middle.left(3) },
+    };
+
+    std::printf("%-20s %8s %12s %12s %9s\n", "query", "hits", "index µs", "scan µs", "speedup");
+    for (const Query& query : queries) {
+        int hits = 0;
+        timer.restart();
+        for (int r = 0; r < QueryRepeats; ++r) {
+            hits = index.search(query.text, limit).size();
+        }
+        const double indexUs = timer.nsecsElapsed() / 1e3 / QueryRepeats;
+
+        // The scan is orders of magnitude slower; a few runs are enough
+        const QStringList words = query.text.split(' ', Qt::SkipEmptyParts);
+        const int scanRepeats = 3;
+        timer.restart();
+        for (int r = 0; r < scanRepeats; ++r) {
+            linearScan(contents, words, limit);
+        }
+        const double scanUs = timer.nsecsElapsed() / 1e3 / scanRepeats;
+
+        std::printf("%-20s %8d %12.1f %12.1f %8.0fx\n", query.name, hits, indexUs, scanUs,
+                    scanUs / qMax(0.001, indexUs));
+    }
+
+    // Incremental update: posts appended to a built index, as createPost does
+    timer.restart();
+    for (int i = 0; i < 10000; ++i) {
+        index.addDocument(authors.at(i), contents.at(i));
+    }
+    std::printf("incremental add: %.2f µs/post\n", timer.nsecsElapsed() / 1e3 / 10000);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#ifndef BENCHCOMMON_H
+#define BENCHCOMMON_H
+
+// ============================================================================
+// BENCHMARK HELPERS
+// Synthetic feed/message data and the widget trees the client used to build
+// per item (inline style sheets, per-widget shadow effects), kept as the
+// "before" baseline. BenchReport collects results as JSON so runs can be
+// compared between releases.
+// ============================================================================
+
+#include "../datatypes.h"
+#include "../timeformatter.h"
+#include <QColor>
+#include <QDateTime>
+#include <QFile>
+#include <QFrame>
+#include <QGraphicsDropShadowEffect>
+#include <QGuiApplication>
+#include <QHBoxLayout>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLabel>
+#include <QPushButton>
+#include <QStringList>
+#include <QVBoxLayout>
+#include <cstdio>
+
+inline QVector<Post> samplePosts(int count)
+{
+    QVector<Post> posts;
+    posts.reserve(count);
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (int i = 0; i < count; ++i) {
+        Post post;
+        post.username = QString("user_%1").arg(i % 500);
+        post.content = QString("Post number %1. Just had the most amazing coffee at the new café "
+                               "downtown! The ambiance is perfect for creative projects.").arg(i);
+        post.createdAt = now - (i % 24 + 1) * 3600;
+        post.likes = i % 300;
+        post.comments = i % 40;
+        post.isPriority = (i % 7 == 0);
+        post.postId = quint64(i + 1);
+        posts.append(post);
+    }
+    return posts;
+}
+
+// The card MainWindow::createPostCard used to build for every post
+inline QWidget* legacyPostCard(const Post& post)
+{
+    QFrame* card = new QFrame();
+    card->setObjectName("postCard");
+    card->setStyleSheet("#postCard { background-color: #1a1a1a; border-radius: 15px; padding: 15px; }");
+
+    QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect();
+    shadow->setBlurRadius(15);
+    shadow->setOffset(0, 5);
+    shadow->setColor(QColor(0, 0, 0, 30));
+    card->setGraphicsEffect(shadow);
+
+    QVBoxLayout* cardLayout = new QVBoxLayout(card);
+    QHBoxLayout* headerLayout = new QHBoxLayout();
+    QLabel* avatar = new QLabel("😊");
+    avatar->setFixedSize(40, 40);
+    avatar->setStyleSheet("background: #6B3FA0; border-radius: 20px;");
+    headerLayout->addWidget(avatar);
+    QLabel* username = new QLabel(post.username);
+    username->setStyleSheet("color: white; font-weight: bold; font-size: 15px;");
+    headerLayout->addWidget(username);
+    if (post.isPriority) {
+        headerLayout->addWidget(new QLabel("⭐"));
+    }
+    headerLayout->addStretch();
+    QLabel* timestamp = new QLabel(TimeFormatter::relative(post.createdAt));
+    timestamp->setStyleSheet("color: #999; font-size: 12px;");
+    headerLayout->addWidget(timestamp);
+    cardLayout->addLayout(headerLayout);
+
+    QFrame* contentBubble = new QFrame();
+    contentBubble->setStyleSheet("background: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #6B3FA0, stop:1 #4B2A70);"
+                                 "border-radius: 12px; padding: 15px;");
+    QVBoxLayout* bubbleLayout = new QVBoxLayout(contentBubble);
+    QLabel* contentLabel = new QLabel(post.content);
+    contentLabel->setStyleSheet("color: white; font-size: 14px;");
+    contentLabel->setWordWrap(true);
+    bubbleLayout->addWidget(contentLabel);
+    cardLayout->addWidget(contentBubble);
+
+    QHBoxLayout* actionsLayout = new QHBoxLayout();
+    const QString actionBtnStyle = "QPushButton { background: transparent; color: #FF1493; border: 1px solid #FF1493;"
+                                   " border-radius: 8px; padding: 8px 15px; font-size: 13px; }";
+    const QStringList labels = { QString("❤️ %1").arg(post.likes), QString("💬 %1").arg(post.comments), "📤 Share" };
+    for (const QString& label : labels) {
+        QPushButton* button = new QPushButton(label);
+        button->setStyleSheet(actionBtnStyle);
+        actionsLayout->addWidget(button);
+    }
+    actionsLayout->addStretch();
+    cardLayout->addLayout(actionsLayout);
+    return card;
+}
+
+inline QVector<Message> sampleMessages(int count)
+{
+    QVector<Message> messages;
+    messages.reserve(count);
+    const qint64 start = QDateTime::currentSecsSinceEpoch() - qint64(count) * 60;
+    for (int i = 0; i < count; ++i) {
+        const bool outgoing = (i % 2 == 1);
+        messages.append({
+            outgoing ? QString("You") : QString("Alice"),
+            QString("Message %1: the panda login screen is so cute, can't wait to show everyone!").arg(i),
+            start + qint64(i) * 60,
+            outgoing
+        });
+    }
+    return messages;
+}
+
+// The bubble MainWindow::createMessageBubble used to build (inline QSS)
+inline QWidget* legacyMessageBubble(const Message& msg)
+{
+    QWidget* bubbleWidget = new QWidget();
+    QHBoxLayout* layout = new QHBoxLayout(bubbleWidget);
+    layout->setContentsMargins(0, 5, 0, 5);
+    if (msg.isOutgoing) {
+        layout->addStretch();
+    }
+
+    QFrame* bubble = new QFrame();
+    bubble->setMaximumWidth(400);
+    bubble->setStyleSheet(msg.isOutgoing
+        ? "background-color: #1a1a1a; color: white; border-radius: 15px; padding: 12px 16px;"
+        : "background: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #6B3FA0, stop:1 #4B2A70);"
+          "color: white; border-radius: 15px; padding: 12px 16px;");
+
+    QVBoxLayout* bubbleLayout = new QVBoxLayout(bubble);
+    bubbleLayout->setSpacing(5);
+    QLabel* senderLabel = new QLabel(msg.sender);
+    senderLabel->setStyleSheet("font-weight: bold; font-size: 12px; color: #FFD700;");
+    bubbleLayout->addWidget(senderLabel);
+    QLabel* contentLabel = new QLabel(msg.content);
+    contentLabel->setStyleSheet("font-size: 14px;");
+    contentLabel->setWordWrap(true);
+    bubbleLayout->addWidget(contentLabel);
+    QLabel* timeLabel = new QLabel(TimeFormatter::clock(msg.sentAt));
+    timeLabel->setStyleSheet("font-size: 11px; color: rgba(255,255,255,0.7);");
+    timeLabel->setAlignment(Qt::AlignRight);
+    bubbleLayout->addWidget(timeLabel);
+
+    layout->addWidget(bubble);
+    if (!msg.isOutgoing) {
+        layout->addStretch();
+    }
+    return bubbleWidget;
+}
+
+// Named results of one benchmark run, printed as they are added and
+// written as one JSON document:
+//   { "benchmark", "qtVersion", "platform", "timestamp",
+//     "results": [ { "name", "value", "unit", "params": {...} } ] }
+class BenchReport
+{
+public:
+    explicit BenchReport(const QString& benchmark) : m_benchmark(benchmark) {}
+
+    void add(const QString& name, double value, const QString& unit,
+             const QJsonObject& params = QJsonObject())
+    {
+        std::printf("%-40s %12.3f %s\n", qPrintable(name), value, qPrintable(unit));
+        m_results.append(QJsonObject{
+            { "name", name }, { "value", value }, { "unit", unit }, { "params", params }
+        });
+    }
+
+    bool write(const QString& path) const
+    {
+        const QJsonObject report{
+            { "benchmark", m_benchmark },
+            { "qtVersion", QString(qVersion()) },
+            { "platform", QGuiApplication::platformName() },
+            { "timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+            { "results", m_results }
+        };
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "Could not write %s: %s\n", qPrintable(path), qPrintable(file.errorString()));
+            return false;
+        }
+        file.write(QJsonDocument(report).toJson());
+        return true;
+    }
+
+private:
+    QString m_benchmark;
+    QJsonArray m_results;
+};
+
+#endif // BENCHCOMMON_H
@@ -0,0 +1,37 @@
+#include "../messagebroker.h"
+#include "../messagebus.h"
+#include "../credentialstore.h"
+#include <QCoreApplication>
+#include <QDebug>
+
+// ============================================================================
+// BROKER PROCESS
+// Runs the local message bus for every client on this machine. Clients
+// subscribe with session tokens signed by the key beside users.dat, so run
+// it from the app's data directory or pass the users.dat path.
+// Usage: messagebroker [server-name] [users-file]
+// ============================================================================
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    const QString serverName = argc > 1 ? QString(argv[1]) : QString(MessageBus::DefaultServerName);
+    const QString usersFile = argc > 2 ? QString(argv[2]) : QString("users.dat");
+    
+    QByteArray sessionKey;
+    QString error;
+    if (!CredentialStore::loadSessionKey(usersFile, &sessionKey, &error)) {
+        qDebug() << "messagebroker: no session key for" << usersFile << ":" << error;
+        return 1;
+    }
+    
+    MessageBroker broker;
+    if (!broker.listen(serverName, sessionKey)) {
+        qDebug() << "messagebroker:" << broker.errorString();
+        return 1;
+    }
+    qDebug() << "messagebroker: listening on" << serverName;
+    
+    return app.exec();
+}
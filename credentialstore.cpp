@@ -0,0 +1,421 @@
+#include "credentialstore.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMessageAuthenticationCode>
+#include <QPasswordDigestor>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char UserStoreMagic[8] = { 'P', 'S', 'U', 'S', 'E', 'R', 'S', '1' };
+const quint32 UserStoreVersion = 1;
+const int HeaderSize = 16;
+const int FrameHeaderSize = 4;              // quint32 length
+const quint32 MaxFrameSize = 64 * 1024;
+const int SaltBytes = 16;
+const int HashBytes = 32;                   // SHA-256 output
+const int SessionNonceBytes = 16;
+const int SessionKeyBytes = 32;
+const char* const SessionKeyFile = "session.key";
+
+QByteArray randomBytes(int count)
+{
+    QByteArray bytes(count, '\0');
+    QRandomGenerator::system()->generate(reinterpret_cast<quint32*>(bytes.data()),
+                                         reinterpret_cast<quint32*>(bytes.data() + count));
+    return bytes;
+}
+
+// Comparison time does not depend on where the inputs differ
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    uchar diff = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        diff |= uchar(a.at(i) ^ b.at(i));
+    }
+    return diff == 0;
+}
+
+qint64 now()
+{
+    return QDateTime::currentSecsSinceEpoch();
+}
+
+QByteArray sessionMac(const QByteArray& key, const QString& username, const QByteArray& claims)
+{
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, key);
+    mac.addData(username.toUtf8());
+    mac.addData(QByteArray(1, '\0'));
+    mac.addData(claims);
+    return mac.result().toHex();
+}
+
+} // namespace
+
+CredentialStore::CredentialStore()
+    : m_cacheKey(randomBytes(32))
+{
+}
+
+CredentialStore::~CredentialStore()
+{
+    close();
+}
+
+bool CredentialStore::open(const QString& path, const Options& options)
+{
+    close();
+    QWriteLocker locker(&m_lock);
+    m_options = options;
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    // New file: write the header
+    if (m_file.size() == 0) {
+        char header[HeaderSize] = {};
+        std::memcpy(header, UserStoreMagic, sizeof(UserStoreMagic));
+        qToLittleEndian<quint32>(UserStoreVersion, header + 8);
+        if (m_file.write(header, HeaderSize) != HeaderSize || !m_file.flush()) {
+            m_error = m_file.errorString();
+            m_file.close();
+            return false;
+        }
+    }
+
+    char header[HeaderSize];
+    if (!m_file.seek(0) || m_file.read(header, HeaderSize) != HeaderSize
+        || std::memcmp(header, UserStoreMagic, sizeof(UserStoreMagic)) != 0
+        || qFromLittleEndian<quint32>(header + 8) != UserStoreVersion) {
+        m_error = "users.dat has an invalid header";
+        m_file.close();
+        return false;
+    }
+
+    // Signs the session tokens; shared with the broker through the file
+    QString keyError;
+    if (!loadSessionKey(path, &m_sessionKey, &keyError)) {
+        m_error = keyError;
+        m_file.close();
+        return false;
+    }
+
+    // Build the username index; later frames win. A torn tail is cut off.
+    const qint64 fileSize = m_file.size();
+    qint64 offset = HeaderSize;
+    while (offset + FrameHeaderSize <= fileSize) {
+        char lengthBytes[FrameHeaderSize];
+        if (m_file.read(lengthBytes, FrameHeaderSize) != FrameHeaderSize) {
+            break;
+        }
+        const quint32 length = qFromLittleEndian<quint32>(lengthBytes);
+        if (length > MaxFrameSize || offset + FrameHeaderSize + length > fileSize) {
+            break;
+        }
+
+        QDataStream in(m_file.read(length));
+        in.setVersion(QDataStream::Qt_5_12);
+        Credential credential;
+        in >> credential.userId >> credential.username >> credential.salt >> credential.hash
+           >> credential.iterations >> credential.createdAt;
+        if (in.status() != QDataStream::Ok) {
+            break;
+        }
+        m_nextUserId = qMax(m_nextUserId, credential.userId + 1);
+        m_users.insert(credential.username, credential);
+        m_names.insert(credential.userId, credential.username);
+        offset += FrameHeaderSize + length;
+    }
+
+    if (offset < fileSize && !m_file.resize(offset)) {
+        m_error = m_file.errorString();
+        m_file.close();
+        m_users.clear();
+        m_names.clear();
+        return false;
+    }
+
+    m_error.clear();
+    return true;
+}
+
+void CredentialStore::close()
+{
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_file.isOpen()) {
+            m_file.close();
+        }
+        m_users.clear();
+        m_names.clear();
+        m_nextUserId = 1;
+    }
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    m_verified.clear();
+    m_sessions.clear();
+}
+
+bool CredentialStore::isOpen() const
+{
+    QReadLocker locker(&m_lock);
+    return m_file.isOpen();
+}
+
+QString CredentialStore::errorString() const
+{
+    QReadLocker locker(&m_lock);
+    return m_error;
+}
+
+int CredentialStore::userCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_users.size();
+}
+
+bool CredentialStore::contains(const QString& username) const
+{
+    QReadLocker locker(&m_lock);
+    return m_users.contains(username);
+}
+
+quint32 CredentialStore::userId(const QString& username) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_users.constFind(username);
+    return it == m_users.constEnd() ? 0 : it->userId;
+}
+
+QString CredentialStore::username(quint32 userId) const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.value(userId);
+}
+
+bool CredentialStore::registerUser(const QString& username, const QString& password)
+{
+    if (username.isEmpty() || password.isEmpty()) {
+        return false;
+    }
+
+    // Hash before taking the lock; the id is filled in under it
+    Credential credential = makeCredential(username, password, 0);
+
+    QWriteLocker locker(&m_lock);
+    if (!m_file.isOpen()) {
+        m_error = "users.dat is not open";
+        return false;
+    }
+    if (m_users.contains(username)) {
+        m_error = QString("user %1 already exists").arg(username);
+        return false;
+    }
+    credential.userId = m_nextUserId++;
+    if (!appendRecord(credential)) {
+        return false;
+    }
+    m_users.insert(username, credential);
+    m_names.insert(credential.userId, username);
+    locker.unlock();
+
+    rememberVerified(username, password, credential.salt);
+    return true;
+}
+
+bool CredentialStore::verify(const QString& username, const QString& password)
+{
+    Credential credential;
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_users.constFind(username);
+        if (it == m_users.constEnd()) {
+            return false;
+        }
+        credential = it.value();
+    }
+
+    // Verified recently with the same password: skip the slow hash
+    {
+        const QByteArray digest = fastDigest(password, credential.salt);
+        QMutexLocker cacheLocker(&m_cacheMutex);
+        auto cached = m_verified.constFind(username);
+        if (cached != m_verified.constEnd() && cached->expiresAt > now()
+            && cached->salt == credential.salt && constantTimeEquals(cached->digest, digest)) {
+            return true;
+        }
+    }
+
+    m_slowHashes.fetchAndAddRelaxed(1);
+    if (!constantTimeEquals(deriveHash(password, credential.salt, credential.iterations),
+                            credential.hash)) {
+        return false;
+    }
+
+    // Stored below the current cost: rehash now that we know the password
+    if (credential.iterations < m_options.iterations) {
+        Credential upgraded = makeCredential(username, password, credential.userId);
+        upgraded.createdAt = credential.createdAt;
+        QWriteLocker locker(&m_lock);
+        if (m_users.value(username).salt == credential.salt && appendRecord(upgraded)) {
+            m_users.insert(username, upgraded);
+            credential = upgraded;
+        }
+    }
+
+    rememberVerified(username, password, credential.salt);
+    return true;
+}
+
+bool CredentialStore::loadSessionKey(const QString& usersPath, QByteArray* key, QString* error)
+{
+    QFile file(QFileInfo(usersPath).dir().filePath(SessionKeyFile));
+
+    // First process to get here creates it, readable by this OS user only
+    if (file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+        const QByteArray bytes = randomBytes(SessionKeyBytes);
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+        if (file.write(bytes) != bytes.size() || !file.flush()) {
+            *error = file.errorString();
+            file.remove();
+            return false;
+        }
+        *key = bytes;
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    *key = file.read(SessionKeyBytes + 1);
+    if (key->size() != SessionKeyBytes) {
+        *error = QString("%1 is damaged").arg(file.fileName());
+        key->clear();
+        return false;
+    }
+    return true;
+}
+
+QByteArray CredentialStore::signSession(const QByteArray& key, const QString& username, qint64 expiresAt)
+{
+    const QByteArray claims = QByteArray::number(expiresAt) + '.' + randomBytes(SessionNonceBytes).toHex();
+    return claims + '.' + sessionMac(key, username, claims);
+}
+
+bool CredentialStore::checkSessionToken(const QByteArray& key, const QString& username,
+                                        const QByteArray& token)
+{
+    // expiresAt.nonce.mac
+    const int macStart = token.lastIndexOf('.');
+    if (key.isEmpty() || username.isEmpty() || macStart <= 0) {
+        return false;
+    }
+    const QByteArray claims = token.left(macStart);
+    bool ok = false;
+    const qint64 expiresAt = claims.left(claims.indexOf('.')).toLongLong(&ok);
+    return ok && expiresAt > now()
+        && constantTimeEquals(token.mid(macStart + 1), sessionMac(key, username, claims));
+}
+
+QByteArray CredentialStore::createSession(const QString& username)
+{
+    const qint64 expiresAt = now() + m_options.sessionSeconds;
+    QByteArray token;
+    {
+        QReadLocker keyLocker(&m_lock);
+        token = signSession(m_sessionKey, username, expiresAt);
+    }
+    QMutexLocker locker(&m_cacheMutex);
+    m_sessions.insert(token, { username, expiresAt });
+    return token;
+}
+
+QString CredentialStore::sessionUser(const QByteArray& token)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    auto it = m_sessions.find(token);
+    if (it == m_sessions.end()) {
+        return QString();
+    }
+    if (it->expiresAt <= now()) {
+        m_sessions.erase(it);
+        return QString();
+    }
+    return it->username;
+}
+
+void CredentialStore::endSession(const QByteArray& token)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_sessions.remove(token);
+}
+
+QByteArray CredentialStore::deriveHash(const QString& password, const QByteArray& salt, int iterations)
+{
+    return QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256, password.toUtf8(),
+                                              salt, iterations, HashBytes);
+}
+
+QByteArray CredentialStore::fastDigest(const QString& password, const QByteArray& salt) const
+{
+    // Keyed with a per-process secret, so the cache is useless outside it
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, m_cacheKey);
+    mac.addData(salt);
+    mac.addData(password.toUtf8());
+    return mac.result();
+}
+
+CredentialStore::Credential CredentialStore::makeCredential(const QString& username,
+                                                            const QString& password,
+                                                            quint32 userId) const
+{
+    Credential credential;
+    credential.userId = userId;
+    credential.username = username;
+    credential.salt = randomBytes(SaltBytes);
+    credential.iterations = m_options.iterations;
+    credential.hash = deriveHash(password, credential.salt, credential.iterations);
+    credential.createdAt = now();
+    m_slowHashes.fetchAndAddRelaxed(1);
+    return credential;
+}
+
+bool CredentialStore::appendRecord(const Credential& credential)
+{
+    QByteArray body;
+    QDataStream out(&body, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << credential.userId << credential.username << credential.salt << credential.hash
+        << credential.iterations << credential.createdAt;
+
+    char lengthBytes[FrameHeaderSize];
+    qToLittleEndian<quint32>(quint32(body.size()), lengthBytes);
+
+    const bool ok = m_file.seek(m_file.size())
+        && m_file.write(lengthBytes, FrameHeaderSize) == FrameHeaderSize
+        && m_file.write(body) == body.size()
+        && m_file.flush();
+    if (!ok) {
+        m_error = m_file.errorString();
+    }
+    return ok;
+}
+
+void CredentialStore::rememberVerified(const QString& username, const QString& password,
+                                       const QByteArray& salt)
+{
+    const QByteArray digest = fastDigest(password, salt);
+    QMutexLocker locker(&m_cacheMutex);
+    m_verified.insert(username, { salt, digest, now() + m_options.verifiedCacheSeconds });
+}
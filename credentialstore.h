@@ -0,0 +1,126 @@
+#ifndef CREDENTIALSTORE_H
+#define CREDENTIALSTORE_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+
+// ============================================================================
+// CREDENTIAL STORE (users.dat)
+//
+// File layout (little-endian):
+//   [magic "PSUSERS1"][quint32 version][quint32 reserved]
+//   frames: quint32 length, then a QDataStream body
+//           (userId, username, salt, hash, iterations, createdAt)
+// Append-only; a later frame for the same username replaces the earlier one
+// (password change or cost upgrade).
+//
+// Passwords are stored as salted PBKDF2-HMAC-SHA256 with a per-record
+// iteration count, so the cost can be raised without invalidating old
+// hashes: a successful login below the current cost is rehashed.
+//
+// Lookups go through an in-memory hash index on username. Because the slow
+// hash dominates login cost, two caches let repeat work skip it:
+//   - verified credentials: a keyed fast digest of (salt, password) for
+//     recently verified logins; a repeat login with the same password is
+//     one HMAC instead of a full PBKDF2
+//   - sessions: tokens handed out at login, so later requests carry a
+//     token instead of re-sending the password
+// Session tokens are signed (HMAC-SHA256 over username, expiry and a
+// nonce) with a key kept in session.key beside users.dat, readable by the
+// owner only. Another process with the key, such as the message broker,
+// can check a token for a username without the session table.
+// The slow hash always runs outside every lock, so concurrent logins use
+// all cores.
+// ============================================================================
+
+class CredentialStore
+{
+public:
+    struct Options {
+        int iterations = 120000;              // PBKDF2 rounds for new hashes
+        int verifiedCacheSeconds = 15 * 60;   // How long a verified login skips the slow hash
+        int sessionSeconds = 12 * 3600;
+    };
+
+    CredentialStore();
+    ~CredentialStore();
+
+    bool open(const QString& path, const Options& options = Options());
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    int userCount() const;
+    bool contains(const QString& username) const;
+    quint32 userId(const QString& username) const;   // 0 if unknown
+    QString username(quint32 userId) const;          // Empty if unknown
+
+    bool registerUser(const QString& username, const QString& password);
+    bool verify(const QString& username, const QString& password);
+
+    QByteArray createSession(const QString& username);
+    QString sessionUser(const QByteArray& token);    // Empty if unknown or expired
+    void endSession(const QByteArray& token);
+
+    // Signing key for the users.dat at usersPath, created on first use
+    static bool loadSessionKey(const QString& usersPath, QByteArray* key, QString* error);
+    static QByteArray signSession(const QByteArray& key, const QString& username, qint64 expiresAt);
+    // True if token was signed with key for username and has not expired
+    static bool checkSessionToken(const QByteArray& key, const QString& username, const QByteArray& token);
+
+    // Full PBKDF2 evaluations so far (cache effectiveness)
+    quint64 slowHashCount() const { return m_slowHashes.loadRelaxed(); }
+
+private:
+    Q_DISABLE_COPY(CredentialStore)
+
+    struct Credential {
+        quint32 userId = 0;
+        QString username;
+        QByteArray salt;
+        QByteArray hash;
+        int iterations = 0;
+        qint64 createdAt = 0;
+    };
+
+    struct VerifiedLogin {
+        QByteArray salt;
+        QByteArray digest;
+        qint64 expiresAt;
+    };
+
+    struct Session {
+        QString username;
+        qint64 expiresAt;
+    };
+
+    static QByteArray deriveHash(const QString& password, const QByteArray& salt, int iterations);
+    QByteArray fastDigest(const QString& password, const QByteArray& salt) const;
+    Credential makeCredential(const QString& username, const QString& password, quint32 userId) const;
+    bool appendRecord(const Credential& credential);
+    void rememberVerified(const QString& username, const QString& password, const QByteArray& salt);
+
+    Options m_options;
+
+    mutable QReadWriteLock m_lock;     // Guards the index, file and error
+    QFile m_file;
+    QHash<QString, Credential> m_users;
+    QHash<quint32, QString> m_names;   // userId -> username
+    QByteArray m_sessionKey;
+    quint32 m_nextUserId = 1;
+    QString m_error;
+
+    QMutex m_cacheMutex;               // Guards the two caches
+    QByteArray m_cacheKey;             // Random per process; never stored
+    QHash<QString, VerifiedLogin> m_verified;
+    QHash<QByteArray, Session> m_sessions;
+
+    mutable QAtomicInteger<quint64> m_slowHashes;
+};
+
+#endif // CREDENTIALSTORE_H
@@ -0,0 +1,122 @@
+#ifndef DATATYPES_H
+#define DATATYPES_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// ============================================================================
+// DATA STRUCTURES (mirror the C++ backend records)
+// ============================================================================
+
+struct Post {
+    QString username;
+    QString content;
+    qint64 createdAt = 0;   // Seconds since epoch; TimeFormatter renders it
+    int likes;
+    int comments;
+    bool isPriority;   // Close friend post
+    QString media;
+    quint64 postId = 0;
+};
+
+struct FeedPage {
+    QVector<Post> posts;
+    QByteArray nextCursor;   // Opaque; pass back to fetch the following page
+    bool atEnd;
+    int generation = 0;      // Login the page was requested for
+};
+
+struct Message {
+    QString sender;
+    QString content;
+    qint64 sentAt = 0;      // Seconds since epoch
+    bool isOutgoing;
+    int index = -1;   // Position in the conversation (-1 = not stored yet)
+};
+
+struct MessagePage {
+    QString viewer;
+    QString partner;
+    QVector<Message> messages;   // Oldest first
+    int firstIndex = 0;          // Conversation position of messages[0]
+    int total = 0;               // Messages in the conversation
+    int before = -1;             // Requested end position (-1 = newest page)
+};
+
+struct ConversationPreview {
+    QString partner;
+    QString lastMessage;
+    qint64 lastSentAt = 0;   // Seconds since epoch; TimeFormatter renders it
+    int messageCount;
+};
+
+struct User {
+    QString username;
+    QString displayName;
+    QString avatarPath;
+    int followerCount;
+    int followingCount;
+    bool isCloseFriend;
+};
+
+struct Notification {
+    QString text;        // Coalesced, e.g. "alice and 12 others liked your post"
+    qint64 updatedAt = 0;   // Seconds since epoch
+    bool isPriority;     // From a close friend
+    bool isUnread;
+};
+
+struct NotificationList {
+    QString username;
+    QVector<Notification> priority;   // Newest first
+    QVector<Notification> regular;
+};
+
+struct StoryRing {
+    QString username;
+    int storyCount;      // Live stories (0 only for the viewer's own ring)
+    qint64 latestAt = 0;   // Newest story, seconds since epoch (0 = none)
+    bool isCloseFriend;
+    bool isOwn;
+};
+
+struct StoryRingList {
+    QString username;
+    QVector<StoryRing> rings;   // Own first, then close friends, then the rest
+};
+
+struct Story {
+    QString username;
+    QString caption;
+    QString media;
+    qint64 createdAt = 0;   // Seconds since epoch
+};
+
+struct StoryPage {
+    QString viewer;
+    QString author;
+    QVector<Story> stories;   // Oldest first
+};
+
+struct SearchResults {
+    QString query;
+    QVector<Post> posts;    // Newest first
+    QStringList users;      // Authors whose name starts with the query
+    int generation = 0;     // Keystroke the results answer
+};
+
+Q_DECLARE_METATYPE(Post)
+Q_DECLARE_METATYPE(FeedPage)
+Q_DECLARE_METATYPE(Message)
+Q_DECLARE_METATYPE(MessagePage)
+Q_DECLARE_METATYPE(ConversationPreview)
+Q_DECLARE_METATYPE(User)
+Q_DECLARE_METATYPE(NotificationList)
+Q_DECLARE_METATYPE(SearchResults)
+Q_DECLARE_METATYPE(StoryRingList)
+Q_DECLARE_METATYPE(StoryPage)
+
+#endif // DATATYPES_H
@@ -0,0 +1,115 @@
+#include "feedmodel.h"
+#include "timeformatter.h"
+
+FeedModel::FeedModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int FeedModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_posts.size();
+}
+
+QVariant FeedModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_posts.size()) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole:
+    case ContentRole:
+        return m_posts.content(row);
+    case UsernameRole:
+        return m_posts.username(row);
+    case TimestampRole:
+        return TimeFormatter::relative(m_posts.createdAt(row));
+    case CreatedAtRole:
+        return m_posts.createdAt(row);
+    case LikesRole:
+        return m_posts.likes(row);
+    case CommentsRole:
+        return m_posts.comments(row);
+    case PriorityRole:
+        return m_posts.isPriority(row);
+    case MediaRole:
+        return m_posts.media(row);
+    case HasMediaRole:
+        return m_posts.hasMedia(row);
+    case PostIdRole:
+        return m_posts.postId(row);
+    case Qt::ToolTipRole:
+        return m_posts.isPriority(row) ? QStringLiteral("Priority Post (Close Friend)") : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> FeedModel::roleNames() const
+{
+    return {
+        { UsernameRole, "username" },
+        { ContentRole, "content" },
+        { TimestampRole, "timestamp" },
+        { LikesRole, "likes" },
+        { CommentsRole, "comments" },
+        { PriorityRole, "isPriority" },
+        { MediaRole, "media" },
+        { PostIdRole, "postId" },
+        { HasMediaRole, "hasMedia" },
+        { CreatedAtRole, "createdAt" }
+    };
+}
+
+void FeedModel::setPosts(const QVector<Post>& posts)
+{
+    beginResetModel();
+    m_posts.clear();
+    m_posts.reserve(posts.size());
+    m_posts.append(posts);
+    endResetModel();
+}
+
+void FeedModel::appendPosts(const QVector<Post>& posts)
+{
+    if (posts.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), m_posts.size(), m_posts.size() + posts.size() - 1);
+    m_posts.append(posts);
+    endInsertRows();
+}
+
+void FeedModel::incrementLikes(int row)
+{
+    if (row < 0 || row >= m_posts.size()) {
+        return;
+    }
+
+    m_posts.incrementLikes(row);
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { LikesRole });
+}
+
+void FeedModel::incrementComments(int row)
+{
+    if (row < 0 || row >= m_posts.size()) {
+        return;
+    }
+
+    m_posts.incrementComments(row);
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { CommentsRole });
+}
+
+void FeedModel::refreshTimestamps()
+{
+    if (m_posts.isEmpty()) {
+        return;
+    }
+
+    emit dataChanged(index(0), index(m_posts.size() - 1), { TimestampRole });
+}
@@ -0,0 +1,56 @@
+#ifndef FEEDMODEL_H
+#define FEEDMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include "datatypes.h"
+#include "posttable.h"
+
+// ============================================================================
+// FEED MODEL
+// List model over the feed posts. The view only asks for the rows it is
+// about to paint, so no per-post widgets are ever created. Rows live in a
+// columnar PostTable; text roles are materialized when they are asked for.
+// ============================================================================
+
+class FeedModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        UsernameRole = Qt::UserRole + 1,
+        ContentRole,
+        TimestampRole,
+        LikesRole,
+        CommentsRole,
+        PriorityRole,
+        MediaRole,
+        PostIdRole,
+        HasMediaRole,     // Without materializing the path
+        CreatedAtRole     // Seconds since epoch (qint64)
+    };
+
+    explicit FeedModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setPosts(const QVector<Post>& posts);
+    void appendPosts(const QVector<Post>& posts);
+    const PostTable& posts() const { return m_posts; }
+    Post postAt(int row) const { return m_posts.post(row); }
+
+    // Counter updates emit dataChanged for one row and one role only
+    void incrementLikes(int row);
+    void incrementComments(int row);
+
+    // Relative times moved on: one dataChanged for every row's timestamp
+    void refreshTimestamps();
+
+private:
+    PostTable m_posts;
+};
+
+#endif // FEEDMODEL_H
@@ -0,0 +1,171 @@
+#include "feedranker.h"
+#include "scratcharena.h"
+#include <QDataStream>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const quint8 CursorVersion = 1;
+
+struct CursorKey {
+    qint64 score;
+    quint32 record;
+};
+
+} // namespace
+
+FeedRanker::FeedRanker()
+{
+}
+
+FeedCursor FeedRanker::encodeCursor(qint64 score, quint32 record)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << CursorVersion << score << record;
+    return bytes.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+}
+
+bool FeedRanker::decodeCursor(const FeedCursor& cursor, qint64* score, quint32* record)
+{
+    if (cursor.isEmpty()) {
+        return false;
+    }
+    const QByteArray bytes = QByteArray::fromBase64(cursor, QByteArray::Base64UrlEncoding);
+    QDataStream in(bytes);
+    quint8 version = 0;
+    in >> version >> *score >> *record;
+    return in.status() == QDataStream::Ok && version == CursorVersion;
+}
+
+void FeedRanker::clear()
+{
+    m_streams.clear();
+    m_streamByAuthor.clear();
+    m_postCount = 0;
+}
+
+void FeedRanker::addPost(quint32 authorId, quint32 record, qint64 createdAt)
+{
+    auto it = m_streamByAuthor.constFind(authorId);
+    int slot;
+    if (it == m_streamByAuthor.constEnd()) {
+        slot = m_streams.size();
+        m_streams.append({ authorId, {} });
+        m_streamByAuthor.insert(authorId, slot);
+    } else {
+        slot = it.value();
+    }
+
+    QVector<StreamEntry>& entries = m_streams[slot].entries;
+    const StreamEntry entry{ createdAt, record };
+    auto before = [](const StreamEntry& a, const StreamEntry& b) {
+        return a.createdAt != b.createdAt ? a.createdAt < b.createdAt : a.record < b.record;
+    };
+    if (entries.isEmpty() || !before(entry, entries.last())) {
+        entries.append(entry);
+    } else {
+        entries.insert(std::upper_bound(entries.begin(), entries.end(), entry, before), entry);
+    }
+    ++m_postCount;
+}
+
+QVector<RankedPost> FeedRanker::topK(int k, const AuthorSet& closeFriends,
+                                     const AuthorSet& authors) const
+{
+    return page(FeedCursor(), k, closeFriends, authors).posts;
+}
+
+RankedPage FeedRanker::page(const FeedCursor& cursor, int pageSize,
+                            const AuthorSet& closeFriends,
+                            const AuthorSet& authors) const
+{
+    RankedPage result{ {}, cursor, true };
+    if (pageSize <= 0) {
+        return result;
+    }
+
+    CursorKey after{ 0, 0 };
+    const bool resume = decodeCursor(cursor, &after.score, &after.record);
+
+    struct Head {
+        qint64 score;
+        quint32 record;
+        int stream;
+        int pos;      // Index of the next entry in the stream (walks backwards)
+        qint64 boost;
+    };
+    auto lower = [](const Head& a, const Head& b) {
+        // Max-heap on score; higher record breaks ties
+        return a.score != b.score ? a.score < b.score : a.record < b.record;
+    };
+
+    ScratchArena::Scope scratch;
+    std::pmr::vector<Head> heap(scratch.resource());
+    heap.reserve(authors.isEmpty() ? size_t(m_streams.size()) : size_t(authors.size()));
+
+    auto addHead = [&](int slot) {
+        const Stream& stream = m_streams.at(slot);
+        const qint64 boost = closeFriends.contains(stream.authorId) ? m_closeFriendBoost : 0;
+
+        // First entry ranked strictly after the cursor
+        int pos = stream.entries.size() - 1;
+        if (resume) {
+            const StreamEntry key{ after.score - boost, after.record };
+            auto it = std::lower_bound(stream.entries.begin(), stream.entries.end(), key,
+                [](const StreamEntry& a, const StreamEntry& b) {
+                    return a.createdAt != b.createdAt ? a.createdAt < b.createdAt : a.record < b.record;
+                });
+            pos = int(it - stream.entries.begin()) - 1;
+        }
+        if (pos < 0) {
+            return;
+        }
+        const StreamEntry& e = stream.entries.at(pos);
+        heap.push_back({ e.createdAt + boost, e.record, slot, pos, boost });
+    };
+
+    if (authors.isEmpty()) {
+        for (int slot = 0; slot < m_streams.size(); ++slot) {
+            addHead(slot);
+        }
+    } else {
+        for (quint32 authorId : authors) {
+            auto it = m_streamByAuthor.constFind(authorId);
+            if (it != m_streamByAuthor.constEnd()) {
+                addHead(it.value());
+            }
+        }
+    }
+
+    // Heapify the stream heads in one O(A) pass rather than A pushes
+    std::make_heap(heap.begin(), heap.end(), lower);
+
+    result.posts.reserve(qMin(pageSize, m_postCount));
+    while (!heap.empty() && result.posts.size() < pageSize) {
+        std::pop_heap(heap.begin(), heap.end(), lower);
+        Head head = heap.back();
+        heap.pop_back();
+
+        const Stream& stream = m_streams.at(head.stream);
+        const StreamEntry& e = stream.entries.at(head.pos);
+        result.posts.append({ e.record, stream.authorId, e.createdAt, head.score, head.boost != 0 });
+
+        // Advance to the author's next older post
+        if (head.pos > 0) {
+            const StreamEntry& next = stream.entries.at(--head.pos);
+            head.score = next.createdAt + head.boost;
+            head.record = next.record;
+            heap.push_back(head);
+            std::push_heap(heap.begin(), heap.end(), lower);
+        }
+    }
+
+    result.atEnd = heap.empty();
+    if (!result.posts.isEmpty()) {
+        const RankedPost& last = result.posts.last();
+        result.next = encodeCursor(last.score, last.record);
+    }
+    return result;
+}
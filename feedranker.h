@@ -0,0 +1,121 @@
+#ifndef FEEDRANKER_H
+#define FEEDRANKER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+// ============================================================================
+// FEED RANKER
+// Keeps one time-ordered stream per author and builds the top K posts for
+// a viewer with a k-way heap merge over the stream heads. Close-friend
+// streams get a constant time boost, so each stream stays sorted by score
+// and a page costs O(A + K log A) for A authors instead of sorting every
+// post; resuming from a cursor adds a binary search per stream.
+// ============================================================================
+
+struct RankedPost {
+    quint32 record;    // Record number in posts.dat
+    quint32 authorId;
+    qint64 createdAt;
+    qint64 score;      // createdAt plus any close-friend boost
+    bool isPriority;
+};
+
+// Opaque position in a ranked feed; an empty cursor means "from the top"
+using FeedCursor = QByteArray;
+
+// Author ids for one ranking request, sorted so lookups are binary
+// searches. Built per request, usually on a ScratchArena, so a page does
+// not allocate a hash node per followed author.
+class AuthorSet
+{
+public:
+    explicit AuthorSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_ids(resource)
+    {
+    }
+
+    // Adds in any order; sort() must run before the set is read
+    void add(quint32 authorId) { m_ids.push_back(authorId); }
+    void reserve(int count) { m_ids.reserve(size_t(count)); }
+    std::pmr::vector<quint32>& ids() { return m_ids; }
+
+    // Sorts and drops duplicates
+    void sort()
+    {
+        std::sort(m_ids.begin(), m_ids.end());
+        m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+    }
+
+    bool contains(quint32 authorId) const { return std::binary_search(m_ids.begin(), m_ids.end(), authorId); }
+    bool isEmpty() const { return m_ids.empty(); }
+    int size() const { return int(m_ids.size()); }
+    std::pmr::vector<quint32>::const_iterator begin() const { return m_ids.begin(); }
+    std::pmr::vector<quint32>::const_iterator end() const { return m_ids.end(); }
+
+private:
+    std::pmr::vector<quint32> m_ids;
+};
+
+struct RankedPage {
+    QVector<RankedPost> posts;
+    FeedCursor next;    // Pass back to page() for the following page
+    bool atEnd;
+};
+
+class FeedRanker
+{
+public:
+    static constexpr qint64 DefaultCloseFriendBoost = 24 * 3600;
+
+    FeedRanker();
+
+    void clear();
+    bool isEmpty() const { return m_postCount == 0; }
+    int postCount() const { return m_postCount; }
+    int authorCount() const { return m_streams.size(); }
+
+    // Inserts a post into its author's stream (O(1) when it is the newest)
+    void addPost(quint32 authorId, quint32 record, qint64 createdAt);
+
+    // How far (in seconds) close-friend posts are promoted in the feed
+    void setCloseFriendBoost(qint64 seconds) { m_closeFriendBoost = seconds; }
+    qint64 closeFriendBoost() const { return m_closeFriendBoost; }
+
+    // Best k posts from the given authors (all authors when the set is empty)
+    QVector<RankedPost> topK(int k, const AuthorSet& closeFriends,
+                             const AuthorSet& authors = AuthorSet()) const;
+
+    // Next pageSize posts ranked strictly after the cursor. Each stream is
+    // re-entered with a binary search, so no per-reader state is kept; the
+    // merge heap lives in the calling thread's ScratchArena.
+    RankedPage page(const FeedCursor& cursor, int pageSize,
+                    const AuthorSet& closeFriends,
+                    const AuthorSet& authors = AuthorSet()) const;
+
+    // Cursor after the post ranked (score, record); shared with the timelines
+    static FeedCursor encodeCursor(qint64 score, quint32 record);
+    static bool decodeCursor(const FeedCursor& cursor, qint64* score, quint32* record);
+
+private:
+    struct StreamEntry {
+        qint64 createdAt;
+        quint32 record;
+    };
+
+    struct Stream {
+        quint32 authorId;
+        QVector<StreamEntry> entries;   // Ascending (createdAt, record)
+    };
+
+    QVector<Stream> m_streams;
+    QHash<quint32, int> m_streamByAuthor;
+    qint64 m_closeFriendBoost = DefaultCloseFriendBoost;
+    int m_postCount = 0;
+};
+
+#endif // FEEDRANKER_H
@@ -0,0 +1,147 @@
+#include "imagecache.h"
+#include <QImageReader>
+#include <QLabel>
+#include <QPainter>
+#include <QPainterPath>
+#include <QThread>
+
+namespace {
+
+const int DefaultCacheKb = 64 * 1024;   // A few screens of full-width media
+
+} // namespace
+
+ImageCache::ImageCache(QObject *parent)
+    : QObject(parent)
+    , m_pixmaps(DefaultCacheKb)
+{
+    // Decoding is I/O plus CPU; leave cores for the backend pool
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount() / 2));
+}
+
+ImageCache::~ImageCache()
+{
+    // Finished decodes are delivered through queued calls to this object
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QString ImageCache::avatarPath(const QString& username)
+{
+    return QString("avatars/%1.png").arg(username);
+}
+
+QString ImageCache::cacheKey(const QString& path, const QSize& size, Shape shape, qreal dpr)
+{
+    return QString("%1@%2x%3:%4:%5").arg(path).arg(size.width()).arg(size.height()).arg(int(shape)).arg(dpr);
+}
+
+QPixmap ImageCache::pixmap(const QString& path, const QSize& size, Shape shape, qreal dpr)
+{
+    if (path.isEmpty() || size.isEmpty()) {
+        return QPixmap();
+    }
+
+    const QString key = cacheKey(path, size, shape, dpr);
+    if (const QPixmap* cached = m_pixmaps.object(key)) {
+        return *cached;
+    }
+    if (m_pending.contains(key) || m_failed.contains(key)) {
+        return QPixmap();
+    }
+
+    m_pending.insert(key);
+    const QSize pixels = size * dpr;
+    m_pool.start([this, key, path, pixels, shape, dpr]() {
+        const QImage image = decode(path, pixels, shape);
+        QMetaObject::invokeMethod(this, [this, key, path, image, dpr]() {
+            finish(key, path, image, dpr);
+        }, Qt::QueuedConnection);
+    }, ++m_requestSerial);
+    return QPixmap();
+}
+
+void ImageCache::load(QLabel* label, const QString& path, const QSize& size, Shape shape)
+{
+    const qreal dpr = label->devicePixelRatioF();
+    const QPixmap cached = pixmap(path, size, shape, dpr);
+    if (!cached.isNull()) {
+        label->setPixmap(cached);
+        return;
+    }
+    const QString key = cacheKey(path, size, shape, dpr);
+    if (m_pending.contains(key)) {
+        m_waitingLabels.insert(key, QPointer<QLabel>(label));
+    }
+}
+
+void ImageCache::finish(const QString& key, const QString& path, const QImage& image, qreal dpr)
+{
+    m_pending.remove(key);
+    const QList<QPointer<QLabel>> labels = m_waitingLabels.values(key);
+    m_waitingLabels.remove(key);
+    if (image.isNull()) {
+        m_failed.insert(key);
+        return;
+    }
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(dpr);
+    const int costKb = qMax(1, int(qint64(image.sizeInBytes()) / 1024));
+    m_pixmaps.insert(key, new QPixmap(pixmap), costKb);
+
+    for (const QPointer<QLabel>& label : labels) {
+        if (label) {
+            label->setPixmap(pixmap);
+        }
+    }
+    emit imageReady(path);
+}
+
+QImage ImageCache::decode(const QString& path, const QSize& size, Shape shape)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    // Let the reader scale (and crop) while decoding where the format
+    // supports it, instead of decoding at full size first
+    const QSize source = reader.size();
+    if (source.isValid()) {
+        const QSize scaled = source.scaled(size, shape == Fit ? Qt::KeepAspectRatio
+                                                              : Qt::KeepAspectRatioByExpanding);
+        reader.setScaledSize(scaled);
+        if (shape != Fit) {
+            reader.setScaledClipRect(QRect(QPoint((scaled.width() - size.width()) / 2,
+                                                  (scaled.height() - size.height()) / 2), size));
+        }
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return image;
+    }
+
+    // Size unknown up front: scale the full decode instead
+    if (!source.isValid()) {
+        image = image.scaled(size, shape == Fit ? Qt::KeepAspectRatio : Qt::KeepAspectRatioByExpanding,
+                             Qt::SmoothTransformation);
+        if (shape != Fit) {
+            image = image.copy(QRect(QPoint((image.width() - size.width()) / 2,
+                                            (image.height() - size.height()) / 2), size));
+        }
+    }
+
+    if (shape == Circle) {
+        QImage masked(size, QImage::Format_ARGB32_Premultiplied);
+        masked.fill(Qt::transparent);
+        QPainter painter(&masked);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        QPainterPath circle;
+        circle.addEllipse(QRectF(QPointF(0, 0), QSizeF(size)));
+        painter.setClipPath(circle);
+        painter.drawImage(0, 0, image);
+        painter.end();
+        return masked;
+    }
+    return image;
+}
@@ -0,0 +1,82 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+class QLabel;
+
+// ============================================================================
+// IMAGE CACHE
+// Avatars, story circles and post media, decoded off the GUI thread.
+//
+// A request that misses returns a null pixmap and queues the decode on a
+// private thread pool: QImageReader scales while decoding (JPEG decodes
+// straight at the reduced size) and crops or masks to the requested shape,
+// so the GUI thread only converts the finished QImage to a QPixmap. Callers
+// paint a placeholder meanwhile and swap the image in on imageReady().
+// Newer requests are decoded first, so a fast scroll serves the rows now on
+// screen before the ones it flew past.
+//
+// Pixmaps are kept in an LRU cache keyed by (path, size, shape, device
+// pixel ratio) and bounded by their size in kilobytes. Paths that fail to
+// decode are remembered and not retried.
+//
+// GUI thread only.
+// ============================================================================
+
+class ImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Shape {
+        Fit,      // Whole image inside the size, aspect kept
+        Fill,     // Covers the size, center-cropped
+        Circle    // Fill, masked to a circle
+    };
+
+    explicit ImageCache(QObject *parent = nullptr);
+    ~ImageCache();
+
+    void setCacheLimit(int kilobytes) { m_pixmaps.setMaxCost(kilobytes); }
+    int cacheLimit() const { return m_pixmaps.maxCost(); }
+
+    // Cached pixmap, or a null one after queueing the decode
+    QPixmap pixmap(const QString& path, const QSize& size, Shape shape = Fit, qreal dpr = 1.0);
+
+    // Sets the label's pixmap now if cached, otherwise once it is decoded;
+    // the label keeps its placeholder until then
+    void load(QLabel* label, const QString& path, const QSize& size, Shape shape = Fit);
+
+    // Where a user's avatar is looked up
+    static QString avatarPath(const QString& username);
+
+    // Decodes one image at the given pixel size (any thread)
+    static QImage decode(const QString& path, const QSize& size, Shape shape);
+
+signals:
+    // A queued decode finished; repaint whatever shows path
+    void imageReady(const QString& path);
+
+private:
+    static QString cacheKey(const QString& path, const QSize& size, Shape shape, qreal dpr);
+    void finish(const QString& key, const QString& path, const QImage& image, qreal dpr);
+
+    QThreadPool m_pool;
+    QCache<QString, QPixmap> m_pixmaps;   // Cost in kilobytes
+    QSet<QString> m_pending;
+    QSet<QString> m_failed;
+    QMultiHash<QString, QPointer<QLabel>> m_waitingLabels;
+    int m_requestSerial = 0;
+};
+
+#endif // IMAGECACHE_H
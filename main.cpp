@@ -0,0 +1,14 @@
+#include "mainwindow.h"
+#include <QApplication>
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    app.setApplicationName("Priority Social");
+
+    MainWindow window;
+    window.resize(1000, 800);
+    window.show();
+
+    return app.exec();
+}
@@ -1,6 +1,17 @@
 #include "mainwindow.h"
-#include <QGraphicsDropShadowEffect>
-#include <QDebug>
+#include "feedmodel.h"
+#include "postcarddelegate.h"
+#include "storymodel.h"
+#include "storydelegate.h"
+#include "backendservice.h"
+#include "imagecache.h"
+#include "startuptrace.h"
+#include "trace.h"
+#include "timeformatter.h"
+#include "appstyle.h"
+#include "shadowframe.h"
+#include <QEvent>
+#include <QFile>
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -10,29 +21,113 @@
 #include <QFrame>
 #include <QPixmap>
 #include <QScrollArea>
+#include <QListView>
+#include <QListWidget>
+#include <QScrollBar>
 #include <QString>
 #include <QStringList>
 #include <QMessageBox>
 #include <QTimer>
-#include <QTime>
+#include <QDateTime>
 #include <QColor>
 #include <QStackedWidget>
 #include <QFont>
 
+namespace {
+
+const int FeedPageSize = 50;
+const int FeedPrefetchCards = 10;   // Fetch the next page this many cards before the end
+const char* const ChatPartner = "Alice";   // Conversation shown on the Messages page
+const int MessagePageSize = 50;   // Messages loaded per request (newest, or older history)
+const int MessagesBottomSlack = 20;   // Pixels from the bottom that still count as "at the bottom"
+const int IncomingBatchMs = 16;       // Pushed messages are added to the layout once per frame
+const int NotificationLimit = 100;    // Rows shown per lane
+const int SearchResultLimit = 100;    // Newest matches shown for a query
+
+// Notification items keep their text and time apart so the minute timer
+// can re-render the time
+const int NotificationTextRole = Qt::UserRole;
+const int NotificationTimeRole = Qt::UserRole + 1;   // Seconds since epoch
+
+void setNotificationLabel(QListWidgetItem* item)
+{
+    item->setText(QString("%1  ·  %2").arg(item->data(NotificationTextRole).toString(),
+                                            TimeFormatter::relative(item->data(NotificationTimeRole).toLongLong())));
+}
+
+QString badgeText(int unread, int priorityUnread)
+{
+    if (unread == 0) {
+        return "🔔";
+    }
+    return QString("🔔 %1%2").arg(unread).arg(priorityUnread > 0 ? " ⭐" : "");
+}
+
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_stackedWidget(new QStackedWidget(this))
+    , m_backend(nullptr)
+    , m_bus(new MessageBusClient(this))
+    , m_images(new ImageCache(this))
 {
-    // Set light green background for main window
-    setStyleSheet("QMainWindow { background-color: #E6FFEA; }");
+    // Opens the stores and replays the WAL
+    {
+        StartupTrace::Phase phase("backend");
+        m_backend = new BackendService(this);
+    }
+    
+    // One style sheet for every page; widgets only carry object names
+    {
+        StartupTrace::Phase phase("style sheet");
+        setStyleSheet(AppStyle::styleSheet());
+    }
     
     setCentralWidget(m_stackedWidget);
     
-    // Create all pages
-    setupLoginPage();
-    setupFeedPage();
-    setupMessagesPage();
-    setupProfilePage();
+    // Only the login page up front; the rest are built after its first frame
+    {
+        StartupTrace::Phase phase("login page");
+        setupLoginPage();
+    }
+    m_loginPage->installEventFilter(this);
+    
+    // Backend results arrive here through queued signals
+    connect(m_backend, &BackendService::authenticated, this, &MainWindow::onAuthenticated);
+    connect(m_backend, &BackendService::feedPageLoaded, this, &MainWindow::onFeedPageLoaded);
+    connect(m_backend, &BackendService::messagesLoaded, this, &MainWindow::onMessagesLoaded);
+    connect(m_backend, &BackendService::userProfileLoaded, this, &MainWindow::onUserProfileLoaded);
+    connect(m_backend, &BackendService::closeFriendStatusSaved, this, &MainWindow::onCloseFriendStatusSaved);
+    connect(m_backend, &BackendService::messageStored, this, &MainWindow::onMessageStored);
+    connect(m_backend, &BackendService::postCreated, this, &MainWindow::onPostCreated);
+    connect(m_backend, &BackendService::notificationsLoaded, this, &MainWindow::onNotificationsLoaded);
+    connect(m_backend, &BackendService::searchResultsLoaded, this, &MainWindow::onSearchResultsLoaded);
+    connect(m_backend, &BackendService::storyRingsLoaded, this, &MainWindow::onStoryRingsLoaded);
+    connect(m_backend, &BackendService::storiesLoaded, this, &MainWindow::onStoriesLoaded);
+    connect(m_backend, &BackendService::storyCreated, this, &MainWindow::onStoryCreated);
+    
+    // Queued even from the GUI thread: emitted while a mutation is applied
+    connect(m_backend, &BackendService::notificationsChanged, this, &MainWindow::onNotificationsChanged,
+            Qt::QueuedConnection);
+    connect(m_backend, &BackendService::mutationLogFailed, this, &MainWindow::onMutationLogFailed,
+            Qt::QueuedConnection);
+    
+    // Live messages: queued as they arrive, laid out together on the next frame
+    m_incomingFlushTimer = new QTimer(this);
+    m_incomingFlushTimer->setSingleShot(true);
+    m_incomingFlushTimer->setInterval(IncomingBatchMs);
+    connect(m_incomingFlushTimer, &QTimer::timeout, this, &MainWindow::flushIncomingMessages);
+    connect(m_bus, &MessageBusClient::messageReceived, this, &MainWindow::onBusMessage);
+    
+    // Relative times ("5 minutes ago") move on together at each minute
+    m_timeLabelTimer = new QTimer(this);
+    m_timeLabelTimer->setSingleShot(true);
+    connect(m_timeLabelTimer, &QTimer::timeout, this, &MainWindow::refreshTimeLabels);
+    m_timeLabelTimer->start(TimeFormatter::msecsToNextMinute());
+    
+    // Periodic hot-path stats, when PRIORITY_SOCIAL_TRACE_STATS asks for them
+    Trace::startStatsDump(this);
     
     // Start with login
     m_stackedWidget->setCurrentWidget(m_loginPage);
@@ -40,6 +135,71 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // Closed before every page was built: report what was measured
+    StartupTrace::finish();
+    Trace::finish();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_loginPage && event->type() == QEvent::Paint) {
+        // First frame of the login screen. The next event loop turn is the
+        // first one that can handle input; idle page building starts there.
+        m_loginPage->removeEventFilter(this);
+        StartupTrace::markFirstFrame();
+        QTimer::singleShot(0, this, [this]() {
+            StartupTrace::markInteractive();
+            buildNextPage();
+        });
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::buildNextPage()
+{
+    // One page per turn so typing on the login screen stays responsive
+    for (Page page : { FeedPage, MessagesPage, ProfilePage, NotificationsPage }) {
+        const QWidget* built = page == FeedPage ? m_feedPage
+                             : page == MessagesPage ? m_messagesPage
+                             : page == ProfilePage ? m_profilePage
+                                                   : m_notificationsPage;
+        if (!built) {
+            ensurePage(page);
+            QTimer::singleShot(0, this, &MainWindow::buildNextPage);
+            return;
+        }
+    }
+    StartupTrace::finish();
+}
+
+void MainWindow::ensurePage(Page page)
+{
+    switch (page) {
+    case FeedPage:
+        if (!m_feedPage) {
+            StartupTrace::Phase phase("feed page");
+            setupFeedPage();
+        }
+        break;
+    case MessagesPage:
+        if (!m_messagesPage) {
+            StartupTrace::Phase phase("messages page");
+            setupMessagesPage();
+        }
+        break;
+    case ProfilePage:
+        if (!m_profilePage) {
+            StartupTrace::Phase phase("profile page");
+            setupProfilePage();
+        }
+        break;
+    case NotificationsPage:
+        if (!m_notificationsPage) {
+            StartupTrace::Phase phase("notifications page");
+            setupNotificationsPage();
+        }
+        break;
+    }
 }
 
 // ============================================================================
@@ -49,7 +209,7 @@ MainWindow::~MainWindow()
 void MainWindow::setupLoginPage()
 {
     m_loginPage = new QWidget();
-    m_loginPage->setStyleSheet("background-color: #E6FFEA;");
+    m_loginPage->setObjectName("loginPage");
     
     QVBoxLayout* mainLayout = new QVBoxLayout(m_loginPage);
     mainLayout->setAlignment(Qt::AlignCenter);
@@ -63,17 +223,12 @@ void MainWindow::setupLoginPage()
     containerLayout->setSpacing(0);
     
     // === PANDA IMAGE (overlapping top of box) ===
-    QLabel* pandaLabel = new QLabel();
-    QPixmap pandaPixmap("panda.png");
-    if (pandaPixmap.isNull()) {
-        pandaPixmap = QPixmap(":/assets/panda.png"); // Try resource path
-    }
-    if (!pandaPixmap.isNull()) {
-        pandaLabel->setPixmap(pandaPixmap.scaled(180, 180, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    } else {
-        pandaLabel->setText("🐼");
-        pandaLabel->setStyleSheet("font-size: 120px;");
-    }
+    // Emoji until the image is decoded (stays if there is none)
+    QLabel* pandaLabel = new QLabel("🐼");
+    pandaLabel->setObjectName("pandaFallback");
+    const QString pandaPath = QFile::exists("panda.png") ? QString("panda.png")
+                                                         : QString(":/assets/panda.png"); // Resource path
+    m_images->load(pandaLabel, pandaPath, QSize(180, 180));
     pandaLabel->setAlignment(Qt::AlignCenter);
     pandaLabel->setFixedHeight(140);
     containerLayout->addWidget(pandaLabel);
@@ -81,33 +236,13 @@ void MainWindow::setupLoginPage()
     // === LOGIN BOX (the box with inputs) ===
     QFrame* loginBox = new QFrame();
     loginBox->setObjectName("loginBox");
-    loginBox->setStyleSheet(
-        "#loginBox {"
-        "   background-color: white;"
-        "   border-radius: 20px;"
-        "   padding: 40px 30px 30px 30px;"
-        "}"
-    );
-    
-    // Add shadow effect
-    QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect();
-    shadow->setBlurRadius(30);
-    shadow->setXOffset(0);
-    shadow->setYOffset(10);
-    shadow->setColor(QColor(0, 0, 0, 50));
-    loginBox->setGraphicsEffect(shadow);
     
     QVBoxLayout* boxLayout = new QVBoxLayout(loginBox);
     boxLayout->setSpacing(20);
     
     // Title
     QLabel* titleLabel = new QLabel("Welcome Back!");
-    titleLabel->setStyleSheet(
-        "font-size: 28px;"
-        "font-weight: bold;"
-        "color: #6B3FA0;"
-        "margin-bottom: 10px;"
-    );
+    titleLabel->setObjectName("loginTitle");
     titleLabel->setAlignment(Qt::AlignCenter);
     boxLayout->addWidget(titleLabel);
     
@@ -134,13 +269,16 @@ void MainWindow::setupLoginPage()
     connect(loginButton, &QPushButton::clicked, this, &MainWindow::handleLogin);
     boxLayout->addWidget(loginButton);
     
-    // Signup link (optional)
+    // Signup link: creates the account from the same two fields
     QLabel* signupLabel = new QLabel("<a href='#' style='color: #6B3FA0;'>Don't have an account? Sign up</a>");
     signupLabel->setAlignment(Qt::AlignCenter);
     signupLabel->setOpenExternalLinks(false);
+    signupLabel->setCursor(Qt::PointingHandCursor);
+    connect(signupLabel, &QLabel::linkActivated, this, &MainWindow::handleSignUp);
     boxLayout->addWidget(signupLabel);
     
-    containerLayout->addWidget(loginBox, 0, Qt::AlignTop);
+    // Cached shadow behind the box (no per-repaint blur)
+    containerLayout->addWidget(new ShadowFrame(loginBox, AppStyle::LoginBoxShadow), 0, Qt::AlignTop);
     mainLayout->addWidget(loginContainer);
     
     m_stackedWidget->addWidget(m_loginPage);
@@ -159,72 +297,140 @@ void MainWindow::setupFeedPage()
     
     // Header with app title and navigation
     QWidget* header = new QWidget();
-    header->setStyleSheet("background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #1a1a1a, stop:1 #6B3FA0); padding: 15px;");
+    header->setObjectName("appHeader");
     header->setFixedHeight(60);
     QHBoxLayout* headerLayout = new QHBoxLayout(header);
     
     QLabel* appTitle = new QLabel("Priority Social");
-    appTitle->setStyleSheet("color: white; font-size: 20px; font-weight: bold;");
+    appTitle->setObjectName("appTitle");
     headerLayout->addWidget(appTitle);
     
     headerLayout->addStretch();
     
+    // Searches as the user types
+    m_searchInput = new QLineEdit();
+    m_searchInput->setPlaceholderText("🔍 Search posts and people");
+    m_searchInput->setObjectName("searchInput");
+    m_searchInput->setClearButtonEnabled(true);
+    m_searchInput->setFixedWidth(260);
+    connect(m_searchInput, &QLineEdit::textChanged, this, &MainWindow::searchPosts);
+    headerLayout->addWidget(m_searchInput);
+    
     // Navigation buttons
     QPushButton* feedBtn = new QPushButton("Feed");
     QPushButton* messagesBtn = new QPushButton("Messages");
     QPushButton* profileBtn = new QPushButton("Profile");
+    m_notificationsButton = new QPushButton(badgeText(0, 0));
     
-    QString navBtnStyle = "QPushButton { background: transparent; color: white; border: none; padding: 8px 15px; font-size: 14px; }"
-                          "QPushButton:hover { background: rgba(255,255,255,0.2); border-radius: 5px; }";
-    feedBtn->setStyleSheet(navBtnStyle);
-    messagesBtn->setStyleSheet(navBtnStyle);
-    profileBtn->setStyleSheet(navBtnStyle);
+    feedBtn->setObjectName("navButton");
+    messagesBtn->setObjectName("navButton");
+    profileBtn->setObjectName("navButton");
+    m_notificationsButton->setObjectName("navButton");
     
     connect(feedBtn, &QPushButton::clicked, this, &MainWindow::showFeed);
     connect(messagesBtn, &QPushButton::clicked, this, &MainWindow::showMessages);
     connect(profileBtn, &QPushButton::clicked, this, &MainWindow::showProfile);
+    connect(m_notificationsButton, &QPushButton::clicked, this, &MainWindow::showNotifications);
     
     headerLayout->addWidget(feedBtn);
     headerLayout->addWidget(messagesBtn);
     headerLayout->addWidget(profileBtn);
+    headerLayout->addWidget(m_notificationsButton);
     
     mainLayout->addWidget(header);
     
     // === STORIES BAR ===
-    QScrollArea* storiesScroll = new QScrollArea();
-    storiesScroll->setWidgetResizable(true);
-    storiesScroll->setFixedHeight(120);
-    storiesScroll->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    storiesScroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    storiesScroll->setStyleSheet("background-color: #F5F5F5; border: none;");
-    
-    QWidget* storiesContainer = new QWidget();
-    QHBoxLayout* storiesLayout = new QHBoxLayout(storiesContainer);
-    storiesLayout->setSpacing(15);
-    storiesLayout->setContentsMargins(15, 10, 15, 10);
-    
-    QStringList storyUsers = {"You", "Alice", "Bob", "Charlie", "Diana", "Eve"};
-    for (const QString& user : storyUsers) {
-        storiesLayout->addWidget(createStoryItem(user));
-    }
-    storiesLayout->addStretch();
-    
-    storiesScroll->setWidget(storiesContainer);
-    mainLayout->addWidget(storiesScroll);
-    
-    // === FEED SCROLL AREA ===
-    m_feedScrollArea = new QScrollArea();
-    m_feedScrollArea->setWidgetResizable(true);
-    m_feedScrollArea->setStyleSheet("background-color: #E6FFEA; border: none;");
-    
-    QWidget* feedContainer = new QWidget();
-    m_feedLayout = new QVBoxLayout(feedContainer);
-    m_feedLayout->setSpacing(20);
-    m_feedLayout->setContentsMargins(20, 20, 20, 20);
-    m_feedLayout->setAlignment(Qt::AlignTop);
+    // Circles are painted by the delegate; rings arrive after login
+    m_storyModel = new StoryModel(this);
+    m_storyDelegate = new StoryDelegate(this);
+    m_storyDelegate->setImageCache(m_images);
+    
+    m_storiesView = new QListView();
+    m_storiesView->setModel(m_storyModel);
+    m_storiesView->setItemDelegate(m_storyDelegate);
+    m_storiesView->setFlow(QListView::LeftToRight);
+    m_storiesView->setWrapping(false);
+    m_storiesView->setUniformItemSizes(true);
+    m_storiesView->setHorizontalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_storiesView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_storiesView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    m_storiesView->setSelectionMode(QAbstractItemView::NoSelection);
+    m_storiesView->setFocusPolicy(Qt::NoFocus);
+    m_storiesView->setSpacing(6);
+    m_storiesView->setViewportMargins(9, 6, 9, 0);
+    m_storiesView->setFixedHeight(120);
+    m_storiesView->setObjectName("storiesView");
+    connect(m_storiesView, &QListView::clicked, this, &MainWindow::openStory);
+    mainLayout->addWidget(m_storiesView);
+    
+    // === COMPOSER ===
+    QWidget* composer = new QWidget();
+    composer->setObjectName("inputArea");
+    QHBoxLayout* composerLayout = new QHBoxLayout(composer);
+    composerLayout->setContentsMargins(15, 10, 15, 10);
+    
+    m_postInput = new QLineEdit();
+    m_postInput->setPlaceholderText("What's on your mind?");
+    m_postInput->setObjectName("messageInput");
+    m_postInput->setMinimumHeight(40);
+    connect(m_postInput, &QLineEdit::returnPressed, this, &MainWindow::createPost);
+    composerLayout->addWidget(m_postInput);
+    
+    QPushButton* postBtn = new QPushButton("Post");
+    postBtn->setObjectName("purpleButton");
+    postBtn->setMinimumHeight(40);
+    postBtn->setFixedWidth(80);
+    postBtn->setCursor(Qt::PointingHandCursor);
+    connect(postBtn, &QPushButton::clicked, this, &MainWindow::createPost);
+    composerLayout->addWidget(postBtn);
+    
+    QPushButton* storyBtn = new QPushButton("Story");
+    storyBtn->setObjectName("purpleButton");
+    storyBtn->setMinimumHeight(40);
+    storyBtn->setFixedWidth(80);
+    storyBtn->setCursor(Qt::PointingHandCursor);
+    connect(storyBtn, &QPushButton::clicked, this, &MainWindow::createStory);
+    composerLayout->addWidget(storyBtn);
+    
+    mainLayout->addWidget(composer);
+    
+    // Authors matching the search, above the matching posts
+    m_searchUsersLabel = new QLabel();
+    m_searchUsersLabel->setObjectName("searchUsers");
+    m_searchUsersLabel->hide();
+    mainLayout->addWidget(m_searchUsersLabel);
+    
+    // === FEED VIEW ===
+    // Cards are painted by the delegate; only visible rows are ever realized
+    m_feedModel = new FeedModel(this);
+    m_searchModel = new FeedModel(this);
+    m_feedDelegate = new PostCardDelegate(this);
+    m_feedDelegate->setImageCache(m_images);
+    connect(m_feedDelegate, &PostCardDelegate::likeClicked, this, &MainWindow::likePost);
+    
+    m_feedView = new QListView();
+    m_feedView->setModel(m_feedModel);
+    m_feedView->setItemDelegate(m_feedDelegate);
+    m_feedView->setUniformItemSizes(true);
+    m_feedView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_feedView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_feedView->setSelectionMode(QAbstractItemView::NoSelection);
+    m_feedView->setFocusPolicy(Qt::NoFocus);
+    m_feedView->setSpacing(10);
+    m_feedView->setObjectName("feedView");
+    mainLayout->addWidget(m_feedView);
+    
+    // Cards and circles painted with placeholders are re-rendered once their
+    // images land
+    connect(m_images, &ImageCache::imageReady, this, [this]() {
+        m_feedView->viewport()->update();
+        m_storiesView->viewport()->update();
+    });
     
-    m_feedScrollArea->setWidget(feedContainer);
-    mainLayout->addWidget(m_feedScrollArea);
+    // Prefetch the next page before the user reaches the bottom
+    QScrollBar* feedScrollBar = m_feedView->verticalScrollBar();
+    connect(feedScrollBar, &QScrollBar::valueChanged, this, &MainWindow::maybeFetchNextFeedPage);
+    connect(feedScrollBar, &QScrollBar::rangeChanged, this, &MainWindow::maybeFetchNextFeedPage);
     
     m_stackedWidget->addWidget(m_feedPage);
 }
@@ -242,17 +448,17 @@ void MainWindow::setupMessagesPage()
     
     // Header
     QWidget* header = new QWidget();
-    header->setStyleSheet("background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #1a1a1a, stop:1 #6B3FA0); padding: 15px;");
+    header->setObjectName("appHeader");
     header->setFixedHeight(60);
     QHBoxLayout* headerLayout = new QHBoxLayout(header);
     
     QPushButton* backBtn = new QPushButton("← Back");
-    backBtn->setStyleSheet("background: transparent; color: white; border: none; font-size: 14px;");
+    backBtn->setObjectName("backButton");
     connect(backBtn, &QPushButton::clicked, this, &MainWindow::showFeed);
     headerLayout->addWidget(backBtn);
     
     QLabel* chatTitle = new QLabel("Messages");
-    chatTitle->setStyleSheet("color: white; font-size: 18px; font-weight: bold;");
+    chatTitle->setObjectName("pageTitle");
     headerLayout->addWidget(chatTitle);
     headerLayout->addStretch();
     
@@ -261,9 +467,10 @@ void MainWindow::setupMessagesPage()
     // Messages scroll area
     m_messagesScrollArea = new QScrollArea();
     m_messagesScrollArea->setWidgetResizable(true);
-    m_messagesScrollArea->setStyleSheet("background-color: #F5F5F5; border: none;");
+    m_messagesScrollArea->setObjectName("messagesScroll");
     
     QWidget* messagesContainer = new QWidget();
+    messagesContainer->setObjectName("messagesContainer");
     m_messagesLayout = new QVBoxLayout(messagesContainer);
     m_messagesLayout->setSpacing(10);
     m_messagesLayout->setContentsMargins(15, 15, 15, 15);
@@ -272,16 +479,21 @@ void MainWindow::setupMessagesPage()
     m_messagesScrollArea->setWidget(messagesContainer);
     mainLayout->addWidget(m_messagesScrollArea);
     
+    // Follow the bottom as bubbles are laid out; load history at the top
+    QScrollBar* messagesScrollBar = m_messagesScrollArea->verticalScrollBar();
+    connect(messagesScrollBar, &QScrollBar::valueChanged, this, &MainWindow::onMessagesScrolled);
+    connect(messagesScrollBar, &QScrollBar::rangeChanged, this, &MainWindow::onMessagesRangeChanged);
+    
     // Message input area
     QWidget* inputArea = new QWidget();
-    inputArea->setStyleSheet("background-color: white; border-top: 1px solid #ddd;");
+    inputArea->setObjectName("inputArea");
     inputArea->setFixedHeight(70);
     QHBoxLayout* inputLayout = new QHBoxLayout(inputArea);
     inputLayout->setContentsMargins(15, 10, 15, 10);
     
     m_messageInput = new QLineEdit();
     m_messageInput->setPlaceholderText("Type a message...");
-    m_messageInput->setStyleSheet("border: 1px solid #ccc; border-radius: 20px; padding: 10px 15px; font-size: 14px;");
+    m_messageInput->setObjectName("messageInput");
     m_messageInput->setMinimumHeight(40);
     inputLayout->addWidget(m_messageInput);
     
@@ -305,24 +517,24 @@ void MainWindow::setupMessagesPage()
 void MainWindow::setupProfilePage()
 {
     m_profilePage = new QWidget();
-    m_profilePage->setStyleSheet("background-color: #E6FFEA;");
+    m_profilePage->setObjectName("profilePage");
     QVBoxLayout* mainLayout = new QVBoxLayout(m_profilePage);
     mainLayout->setContentsMargins(0, 0, 0, 0);
     mainLayout->setSpacing(0);
     
     // Header
     QWidget* header = new QWidget();
-    header->setStyleSheet("background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #1a1a1a, stop:1 #6B3FA0); padding: 15px;");
+    header->setObjectName("appHeader");
     header->setFixedHeight(60);
     QHBoxLayout* headerLayout = new QHBoxLayout(header);
     
     QPushButton* backBtn = new QPushButton("← Back");
-    backBtn->setStyleSheet("background: transparent; color: white; border: none; font-size: 14px;");
+    backBtn->setObjectName("backButton");
     connect(backBtn, &QPushButton::clicked, this, &MainWindow::showFeed);
     headerLayout->addWidget(backBtn);
     
     QLabel* profileTitle = new QLabel("Profile");
-    profileTitle->setStyleSheet("color: white; font-size: 18px; font-weight: bold;");
+    profileTitle->setObjectName("pageTitle");
     headerLayout->addWidget(profileTitle);
     headerLayout->addStretch();
     
@@ -338,11 +550,7 @@ void MainWindow::setupProfilePage()
     // Avatar
     m_profileAvatar = new QLabel();
     m_profileAvatar->setFixedSize(120, 120);
-    m_profileAvatar->setStyleSheet(
-        "background: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #6B3FA0, stop:1 #FF1493);"
-        "border-radius: 60px;"
-        "border: 4px solid white;"
-    );
+    m_profileAvatar->setObjectName("profileAvatar");
     m_profileAvatar->setAlignment(Qt::AlignCenter);
     m_profileAvatar->setText("👤");
     QFont avatarFont = m_profileAvatar->font();
@@ -352,13 +560,13 @@ void MainWindow::setupProfilePage()
     
     // Username
     m_profileUsername = new QLabel("@username");
-    m_profileUsername->setStyleSheet("font-size: 24px; font-weight: bold; color: #333;");
+    m_profileUsername->setObjectName("profileUsername");
     m_profileUsername->setAlignment(Qt::AlignCenter);
     contentLayout->addWidget(m_profileUsername);
     
     // Stats
     m_profileStats = new QLabel("150 Followers • 200 Following");
-    m_profileStats->setStyleSheet("font-size: 14px; color: #666;");
+    m_profileStats->setObjectName("profileStats");
     m_profileStats->setAlignment(Qt::AlignCenter);
     contentLayout->addWidget(m_profileStats);
     
@@ -381,202 +589,86 @@ void MainWindow::setupProfilePage()
 }
 
 // ============================================================================
-// WIDGET CREATION HELPERS
+// NOTIFICATIONS PAGE SETUP
 // ============================================================================
 
-QWidget* MainWindow::createStoryItem(const QString& username)
-{
-    QWidget* storyWidget = new QWidget();
-    storyWidget->setFixedSize(70, 90);
-    
-    QVBoxLayout* layout = new QVBoxLayout(storyWidget);
-    layout->setContentsMargins(0, 0, 0, 0);
-    layout->setSpacing(5);
-    
-    // Story circle (gradient border)
-    QLabel* circle = new QLabel();
-    circle->setFixedSize(64, 64);
-    circle->setStyleSheet(
-        "background: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #FF1493, stop:1 #6B3FA0);"
-        "border-radius: 32px;"
-    );
-    circle->setAlignment(Qt::AlignCenter);
-    circle->setText("😊");
-    QFont circleFont = circle->font();
-    circleFont.setPointSize(24);
-    circle->setFont(circleFont);
-    layout->addWidget(circle, 0, Qt::AlignHCenter);
-    
-    // Username
-    QLabel* nameLabel = new QLabel(username);
-    nameLabel->setStyleSheet("font-size: 11px; color: #333;");
-    nameLabel->setAlignment(Qt::AlignCenter);
-    nameLabel->setWordWrap(true);
-    layout->addWidget(nameLabel);
-    
-    return storyWidget;
-}
-
-QWidget* MainWindow::createPostCard(const Post& post, int index)
-{
-    QFrame* card = new QFrame();
-    card->setObjectName("postCard");
-    card->setStyleSheet(
-        "#postCard {"
-        "   background-color: #1a1a1a;"
-        "   border-radius: 15px;"
-        "   padding: 15px;"
-        "}"
-    );
-    
-    // Add shadow
-    QGraphicsDropShadowEffect* shadow = new QGraphicsDropShadowEffect();
-    shadow->setBlurRadius(15);
-    shadow->setXOffset(0);
-    shadow->setYOffset(5);
-    shadow->setColor(QColor(0, 0, 0, 30));
-    card->setGraphicsEffect(shadow);
-    
-    QVBoxLayout* cardLayout = new QVBoxLayout(card);
-    cardLayout->setSpacing(12);
-    
-    // Header (avatar + username + priority star)
-    QHBoxLayout* headerLayout = new QHBoxLayout();
-    
-    QLabel* avatar = new QLabel();
-    avatar->setFixedSize(40, 40);
-    avatar->setStyleSheet("background: #6B3FA0; border-radius: 20px;");
-    avatar->setAlignment(Qt::AlignCenter);
-    avatar->setText("😊");
-    headerLayout->addWidget(avatar);
-    
-    QLabel* username = new QLabel(post.username);
-    username->setStyleSheet("color: white; font-weight: bold; font-size: 15px;");
-    headerLayout->addWidget(username);
-    
-    if (post.isPriority) {
-        QLabel* star = new QLabel("⭐");
-        star->setStyleSheet("font-size: 18px;");
-        star->setToolTip("Priority Post (Close Friend)");
-        headerLayout->addWidget(star);
-    }
-    
-    headerLayout->addStretch();
-    
-    QLabel* timestamp = new QLabel(post.timestamp);
-    timestamp->setStyleSheet("color: #999; font-size: 12px;");
-    headerLayout->addWidget(timestamp);
-    
-    cardLayout->addLayout(headerLayout);
-    
-    // Content area (purple bubble)
-    QFrame* contentBubble = new QFrame();
-    contentBubble->setStyleSheet(
-        "background: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #6B3FA0, stop:1 #4B2A70);"
-        "border-radius: 12px;"
-        "padding: 15px;"
-    );
-    
-    QVBoxLayout* bubbleLayout = new QVBoxLayout(contentBubble);
-    QLabel* contentLabel = new QLabel(post.content);
-    contentLabel->setStyleSheet("color: white; font-size: 14px; line-height: 1.5;");
-    contentLabel->setWordWrap(true);
-    bubbleLayout->addWidget(contentLabel);
-    
-    cardLayout->addWidget(contentBubble);
-    
-    // Action buttons
-    QHBoxLayout* actionsLayout = new QHBoxLayout();
-    
-    QPushButton* likeBtn = new QPushButton(QString("❤️ %1").arg(post.likes));
-    QPushButton* commentBtn = new QPushButton(QString("💬 %1").arg(post.comments));
-    QPushButton* shareBtn = new QPushButton("📤 Share");
-    
-    QString actionBtnStyle = 
-        "QPushButton {"
-        "   background: transparent;"
-        "   color: #FF1493;"
-        "   border: 1px solid #FF1493;"
-        "   border-radius: 8px;"
-        "   padding: 8px 15px;"
-        "   font-size: 13px;"
-        "}"
-        "QPushButton:hover {"
-        "   background: #FF1493;"
-        "   color: white;"
-        "}";
+void MainWindow::setupNotificationsPage()
+{
+    m_notificationsPage = new QWidget();
+    m_notificationsPage->setObjectName("profilePage");
+    QVBoxLayout* mainLayout = new QVBoxLayout(m_notificationsPage);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+    mainLayout->setSpacing(0);
     
-    likeBtn->setStyleSheet(actionBtnStyle);
-    commentBtn->setStyleSheet(actionBtnStyle);
-    shareBtn->setStyleSheet(actionBtnStyle);
+    // Header
+    QWidget* header = new QWidget();
+    header->setObjectName("appHeader");
+    header->setFixedHeight(60);
+    QHBoxLayout* headerLayout = new QHBoxLayout(header);
     
-    likeBtn->setCursor(Qt::PointingHandCursor);
-    commentBtn->setCursor(Qt::PointingHandCursor);
-    shareBtn->setCursor(Qt::PointingHandCursor);
+    QPushButton* backBtn = new QPushButton("← Back");
+    backBtn->setObjectName("backButton");
+    connect(backBtn, &QPushButton::clicked, this, &MainWindow::showFeed);
+    headerLayout->addWidget(backBtn);
     
-    connect(likeBtn, &QPushButton::clicked, [this, index]() { likePost(index); });
+    QLabel* notificationsTitle = new QLabel("Notifications");
+    notificationsTitle->setObjectName("pageTitle");
+    headerLayout->addWidget(notificationsTitle);
+    headerLayout->addStretch();
     
-    actionsLayout->addWidget(likeBtn);
-    actionsLayout->addWidget(commentBtn);
-    actionsLayout->addWidget(shareBtn);
-    actionsLayout->addStretch();
+    mainLayout->addWidget(header);
     
-    cardLayout->addLayout(actionsLayout);
+    // Priority lane first, then everything else (rows are already coalesced)
+    m_notificationsList = new QListWidget();
+    m_notificationsList->setObjectName("notificationsList");
+    m_notificationsList->setSelectionMode(QAbstractItemView::NoSelection);
+    m_notificationsList->setFocusPolicy(Qt::NoFocus);
+    mainLayout->addWidget(m_notificationsList);
     
-    return card;
+    m_stackedWidget->addWidget(m_notificationsPage);
 }
 
-QWidget* MainWindow::createMessageBubble(const Message& msg)
+// ============================================================================
+// WIDGET CREATION HELPERS
+// ============================================================================
+
+QWidget* MainWindow::createMessageBubble(int row)
 {
+    const bool outgoing = m_messages.isOutgoing(row);
     QWidget* bubbleWidget = new QWidget();
     QHBoxLayout* layout = new QHBoxLayout(bubbleWidget);
     layout->setContentsMargins(0, 5, 0, 5);
     
-    if (msg.isOutgoing) {
+    if (outgoing) {
         layout->addStretch();
     }
     
     QFrame* bubble = new QFrame();
     bubble->setMaximumWidth(400);
     
-    if (msg.isOutgoing) {
-        // Black bubble for sent messages
-        bubble->setStyleSheet(
-            "background-color: #1a1a1a;"
-            "color: white;"
-            "border-radius: 15px;"
-            "padding: 12px 16px;"
-        );
-    } else {
-        // Purple bubble for received messages
-        bubble->setStyleSheet(
-            "background: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #6B3FA0, stop:1 #4B2A70);"
-            "color: white;"
-            "border-radius: 15px;"
-            "padding: 12px 16px;"
-        );
-    }
+    // Black bubble for sent messages, purple for received
+    bubble->setObjectName(outgoing ? "outgoingBubble" : "incomingBubble");
     
     QVBoxLayout* bubbleLayout = new QVBoxLayout(bubble);
     bubbleLayout->setSpacing(5);
     
-    QLabel* senderLabel = new QLabel(msg.sender);
-    senderLabel->setStyleSheet("font-weight: bold; font-size: 12px; color: #FFD700;");
+    QLabel* senderLabel = new QLabel(m_messages.sender(row));
+    senderLabel->setObjectName("bubbleSender");
     bubbleLayout->addWidget(senderLabel);
     
-    QLabel* contentLabel = new QLabel(msg.content);
-    contentLabel->setStyleSheet("font-size: 14px;");
+    QLabel* contentLabel = new QLabel(m_messages.content(row));
+    contentLabel->setObjectName("bubbleContent");
     contentLabel->setWordWrap(true);
     bubbleLayout->addWidget(contentLabel);
     
-    QLabel* timeLabel = new QLabel(msg.timestamp);
-    timeLabel->setStyleSheet("font-size: 11px; color: rgba(255,255,255,0.7);");
+    QLabel* timeLabel = new QLabel(TimeFormatter::clock(m_messages.sentAt(row)));
+    timeLabel->setObjectName("bubbleTime");
     timeLabel->setAlignment(Qt::AlignRight);
     bubbleLayout->addWidget(timeLabel);
     
     layout->addWidget(bubble);
     
-    if (!msg.isOutgoing) {
+    if (!outgoing) {
         layout->addStretch();
     }
     
@@ -584,233 +676,607 @@ QWidget* MainWindow::createMessageBubble(const Message& msg)
 }
 
 // ============================================================================
-// BACKEND INTEGRATION HOOKS
+// BACKEND INTEGRATION
 // ============================================================================
 
-bool MainWindow::authenticateUser(const QString& username, const QString& password)
+void MainWindow::saveCloseFriendStatus(bool status)
 {
-    // TODO: Replace with actual backend call
-    // Example: return authenticate_user_c(username.toStdString().c_str(), password.toStdString().c_str());
+    // The feed reloads once the backend has applied the new mode
+    m_backend->saveCloseFriendStatus(m_currentUser, status);
+    Trace::count("close friend toggles");
     
-    // For now, accept any non-empty credentials
-    return !username.isEmpty() && !password.isEmpty();
+    if (status) {
+        QMessageBox::information(this, "Close Friends Mode", 
+            "You will now see priority posts from your close friends! ⭐");
+    }
 }
 
-QVector<Post> MainWindow::loadFeedPosts()
+// ============================================================================
+// SLOTS (Event Handlers)
+// ============================================================================
+
+void MainWindow::handleLogin()
 {
-    // TODO: Replace with actual backend call to read posts.dat
-    // Example:
-    // Post* posts_array;
-    // int count = load_posts_c(&posts_array);
-    // Convert C array to QVector<Post>
-    
-    // Sample data for demonstration
-    QVector<Post> posts;
+    submitCredentials(false);
+}
+
+void MainWindow::handleSignUp()
+{
+    submitCredentials(true);
+}
+
+void MainWindow::submitCredentials(bool createAccount)
+{
+    QString username = m_usernameInput->text().trimmed();
+    QString password = m_passwordInput->text();
     
-    posts.append({
-        "alice_wonder",
-        "Just had the most amazing coffee at the new café downtown! ☕✨ The ambiance is perfect for working on creative projects. Highly recommend!",
-        "2 hours ago",
-        142,
-        23,
-        true, // Priority post
-        ""
-    });
+    if (username.isEmpty() || password.isEmpty()) {
+        QMessageBox::warning(this, createAccount ? "Sign Up Failed" : "Login Failed",
+                             "Please enter both username and password.");
+        return;
+    }
     
-    posts.append({
-        "bob_builder",
-        "Finally finished my C++ project! 🎉 The feeling of seeing everything compile without errors is unmatched. Time to celebrate! 🚀",
-        "5 hours ago",
-        89,
-        15,
-        false,
-        ""
-    });
+    if (m_authPending) {
+        return;
+    }
     
-    posts.append({
-        "charlie_dev",
-        "Hot take: Qt is underrated for building desktop apps in 2025. The widget system is so powerful and the cross-platform support is chef's kiss 👨‍🍳💋",
-        "1 day ago",
-        256,
-        47,
-        true, // Priority post
-        ""
-    });
+    // Authenticate with backend (result arrives in onAuthenticated)
+    m_authPending = true;
+    m_signUpPending = createAccount;
+    m_backend->authenticate(username, password, createAccount);
+}
+
+void MainWindow::onAuthenticated(const QString& username, bool ok, const QByteArray& sessionToken)
+{
+    Trace::Scope scope("onAuthenticated");
+    m_authPending = false;
     
-    return posts;
+    if (ok) {
+        m_currentUser = username;
+        m_sessionToken = sessionToken;
+        
+        // Usually built in idle time while the user was typing
+        ensurePage(FeedPage);
+        ensurePage(MessagesPage);
+        
+        // Feed, profile and messages load in parallel on the backend pool
+        reloadFeed();
+        m_backend->requestStoryRings(username);
+        m_backend->requestUserProfile(username);
+        clearMessagesView();
+        m_messagesSynced = false;
+        m_bus->start(username, sessionToken);
+        m_notificationsButton->setText(badgeText(m_backend->unreadNotificationCount(username), 0));
+        m_backend->requestMessages(username, ChatPartner, MessagePageSize);
+        
+        // Switch to feed page
+        m_stackedWidget->setCurrentWidget(m_feedPage);
+        
+        QMessageBox::information(this, "Welcome!", 
+            QString(m_signUpPending ? "Welcome, %1! 🎉" : "Welcome back, %1! 🎉").arg(username));
+    } else if (m_signUpPending) {
+        QMessageBox::critical(this, "Sign Up Failed", 
+            QString("The username %1 is already taken. Please choose another one.").arg(username));
+    } else {
+        QMessageBox::critical(this, "Login Failed", 
+            "Invalid username or password. Please try again.\n"
+            "New here? Use \"Sign up\" to create an account.");
+    }
+}
+
+void MainWindow::reloadFeed()
+{
+    // Only the first page is requested; later pages are prefetched on scroll.
+    // Pages still in flight for the old feed are dropped by generation.
+    ++m_feedGeneration;
+    m_feedModel->setPosts(QVector<Post>());
+    m_feedCursor.clear();
+    m_feedAtEnd = false;
+    m_feedPageLoading = true;
+    m_backend->requestFeedPage(m_currentUser, QByteArray(), FeedPageSize, m_feedGeneration);
 }
 
-QVector<Message> MainWindow::loadMessages()
+void MainWindow::maybeFetchNextFeedPage()
 {
-    // TODO: Replace with actual backend call to read messages.dat
-    // Example: Message* msgs; int count = load_messages_c(current_user, &msgs);
+    // The view shows search results while there is a query
+    if (m_feedView->model() != m_feedModel) {
+        return;
+    }
+    if (m_feedAtEnd || m_feedPageLoading || m_currentUser.isEmpty()) {
+        return;
+    }
     
-    QVector<Message> messages;
+    QScrollBar* scrollBar = m_feedView->verticalScrollBar();
+    const int prefetchDistance = FeedPrefetchCards * PostCardDelegate::CardHeight;
+    if (scrollBar->value() < scrollBar->maximum() - prefetchDistance) {
+        return;
+    }
     
-    messages.append({
-        "Alice",
-        "Hey! Did you see the new features?",
-        "10:23 AM",
-        false // incoming
-    });
+    // Rank and materialize the page on a backend worker
+    m_feedPageLoading = true;
+    m_backend->requestFeedPage(m_currentUser, m_feedCursor, FeedPageSize, m_feedGeneration);
+}
+
+void MainWindow::onFeedPageLoaded(const FeedPage& page)
+{
+    Trace::Scope scope("onFeedPageLoaded");
+    // Ignore pages requested before the last login
+    if (page.generation != m_feedGeneration) {
+        return;
+    }
     
-    messages.append({
-        "You",
-        "Yes! The UI looks amazing with the new design!",
-        "10:25 AM",
-        true // outgoing
-    });
+    m_feedPageLoading = false;
+    m_feedModel->appendPosts(page.posts);
+    m_feedCursor = page.nextCursor;
+    m_feedAtEnd = page.atEnd;
     
-    messages.append({
-        "Alice",
-        "I know right! The panda login screen is so cute 🐼",
-        "10:26 AM",
-        false
-    });
+    // Keep going if the view is still short of the prefetch window
+    maybeFetchNextFeedPage();
+}
+
+void MainWindow::searchPosts(const QString& query)
+{
+    // Results for earlier keystrokes still in flight are dropped by generation
+    ++m_searchGeneration;
+    if (query.trimmed().isEmpty()) {
+        m_searchUsersLabel->hide();
+        m_searchModel->setPosts(QVector<Post>());
+        m_feedView->setModel(m_feedModel);
+        maybeFetchNextFeedPage();
+        return;
+    }
+    m_backend->requestSearch(query, SearchResultLimit, m_searchGeneration);
+}
+
+void MainWindow::onSearchResultsLoaded(const SearchResults& results)
+{
+    if (results.generation != m_searchGeneration) {
+        return;
+    }
     
-    messages.append({
-        "You",
-        "Haha yes! Can't wait to show this to everyone",
-        "10:28 AM",
-        true
-    });
+    m_searchModel->setPosts(results.posts);
+    if (m_feedView->model() != m_searchModel) {
+        m_feedView->setModel(m_searchModel);
+    }
+    m_feedView->scrollToTop();
     
-    return messages;
+    m_searchUsersLabel->setText(results.users.isEmpty()
+        ? QString("%1 posts").arg(results.posts.size())
+        : QString("People: %1  ·  %2 posts").arg(results.users.join(", ")).arg(results.posts.size()));
+    m_searchUsersLabel->show();
 }
 
-User MainWindow::loadUserProfile()
+void MainWindow::onMessagesLoaded(const MessagePage& page)
 {
-    // TODO: Replace with actual backend call to read users.dat
-    // Example: User user = get_user_profile_c(current_user.toStdString().c_str());
+    Trace::Scope scope("onMessagesLoaded");
+    // Ignore pages requested before the last login
+    if (page.viewer != m_currentUser) {
+        return;
+    }
+    
+    if (page.before >= 0) {
+        prependOlderMessages(page);
+        return;
+    }
+    
+    // Every message in this chat is on screen once synced; a page read while
+    // some are still being stored can only repeat them
+    if (m_messagesSynced && !m_unstoredRows.isEmpty()) {
+        return;
+    }
     
-    User profile;
-    profile.username = m_currentUser.isEmpty() ? "demo_user" : m_currentUser;
-    profile.displayName = "Demo User";
-    profile.avatarPath = "";
-    profile.followerCount = 150;
-    profile.followingCount = 200;
-    profile.isCloseFriend = false;
+    // First page since login, or more new messages than one page: start over
+    if (!m_messagesSynced || page.firstIndex > m_messagesEnd) {
+        clearMessagesView();
+        m_messagesFirst = page.firstIndex;
+        m_messagesEnd = page.firstIndex;
+        m_messagesSynced = true;
+    }
     
-    return profile;
+    // Append only the messages not already on screen
+    for (const Message& msg : page.messages) {
+        if (msg.index < m_messagesEnd) {
+            continue;
+        }
+        m_messages.append(msg);
+        m_messagesEnd = msg.index + 1;
+    }
+    flushIncomingMessages();
 }
 
-void MainWindow::saveCloseFriendStatus(bool status)
+void MainWindow::onMessageStored(int ticket, int index)
 {
-    // TODO: Replace with actual backend call
-    // Example: update_close_friend_status_c(current_user.toStdString().c_str(), status);
+    // Pushed only once stored: the partner's client shows it at this
+    // position and reads it from the shared messages.dat from then on
+    const QString text = m_unpublished.take(ticket);
+    if (index >= 0 && !text.isNull()) {
+        m_bus->publish(ChatPartner, text, index);
+    }
     
-    qDebug() << "Close friend status updated:" << status;
+    // Messages not shown, or shown before the view was last reset
+    auto it = m_unstoredRows.find(ticket);
+    if (it == m_unstoredRows.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_unstoredRows.erase(it);
+    if (index < 0) {
+        return;   // Not stored; the next load will not include it either
+    }
+    m_messages.setIndex(row, index);
+    m_messagesEnd = qMax(m_messagesEnd, index + 1);
+}
+
+void MainWindow::prependOlderMessages(const MessagePage& page)
+{
+    m_messagesLoadingOlder = false;
     
-    // Optionally reload feed to show/hide priority posts
-    if (status) {
-        QMessageBox::information(this, "Close Friends Mode", 
-            "You will now see priority posts from your close friends! ⭐");
+    // Stale (view was reset since the request)
+    if (page.before != m_messagesFirst || page.messages.isEmpty()) {
+        return;
     }
+    
+    // Keep the visible bubbles where they are while the range grows upwards
+    QScrollBar* scrollBar = m_messagesScrollArea->verticalScrollBar();
+    m_messagesAnchor = scrollBar->maximum() - scrollBar->value();
+    m_messagesStickToBottom = false;
+    
+    m_messages.prepend(page.messages);
+    for (int row = page.messages.size() - 1; row >= 0; --row) {
+        m_messagesLayout->insertWidget(0, createMessageBubble(row));
+    }
+    for (int& row : m_unstoredRows) {
+        row += page.messages.size();
+    }
+    m_messagesFirst = page.firstIndex;
 }
 
-// ============================================================================
-// SLOTS (Event Handlers)
-// ============================================================================
+void MainWindow::clearMessagesView()
+{
+    QLayoutItem* item;
+    while ((item = m_messagesLayout->takeAt(0)) != nullptr) {
+        delete item->widget();
+        delete item;
+    }
+    m_messages.clear();
+    m_unstoredRows.clear();
+    m_messagesFirst = 0;
+    m_messagesEnd = 0;
+    m_messagesLoadingOlder = false;
+    m_messagesStickToBottom = true;
+    m_messagesAnchor = -1;
+}
 
-void MainWindow::handleLogin()
+void MainWindow::onMessagesScrolled(int value)
 {
-    QString username = m_usernameInput->text().trimmed();
-    QString password = m_passwordInput->text();
+    QScrollBar* scrollBar = m_messagesScrollArea->verticalScrollBar();
+    m_messagesStickToBottom = (value >= scrollBar->maximum() - MessagesBottomSlack);
+    if (m_messagesAnchor >= 0 && value != scrollBar->maximum() - m_messagesAnchor) {
+        m_messagesAnchor = -1;   // User moved; stop pinning
+    }
     
-    if (username.isEmpty() || password.isEmpty()) {
-        QMessageBox::warning(this, "Login Failed", "Please enter both username and password.");
+    // Reached the top: fetch the page before the oldest bubble
+    if (value == scrollBar->minimum() && m_messagesSynced && m_messagesFirst > 0
+        && !m_messagesLoadingOlder) {
+        m_messagesLoadingOlder = true;
+        m_backend->requestMessages(m_currentUser, ChatPartner, MessagePageSize, m_messagesFirst);
+    }
+}
+
+void MainWindow::onMessagesRangeChanged(int min, int max)
+{
+    Q_UNUSED(min);
+    QScrollBar* scrollBar = m_messagesScrollArea->verticalScrollBar();
+    if (m_messagesStickToBottom) {
+        scrollBar->setValue(max);
+    } else if (m_messagesAnchor >= 0) {
+        scrollBar->setValue(max - m_messagesAnchor);
+    }
+}
+
+void MainWindow::onBusMessage(const BusMessage& message)
+{
+    if (message.to != m_currentUser) {
         return;
     }
     
-    // Authenticate with backend
-    if (authenticateUser(username, password)) {
-        m_currentUser = username;
-        
-        // Load feed data
-        m_posts = loadFeedPosts();
-        
-        // Clear existing feed and populate with posts
-        QLayoutItem* item;
-        while ((item = m_feedLayout->takeAt(0)) != nullptr) {
-            delete item->widget();
-            delete item;
+    // The sender's client stored it before pushing it
+    m_backend->notifyIncomingMessage(message.from, message.to, message.sentAt);
+    
+    // Other chats, or no page shown yet (the first page will include it)
+    if (message.from != ChatPartner || !m_messagesSynced || message.index < 0) {
+        return;
+    }
+    
+    // Already on screen if a page was read after the sender stored it
+    for (int row = m_messages.size() - 1; row >= 0; --row) {
+        const int shown = m_messages.index(row);
+        if (shown == message.index) {
+            return;
         }
-        
-        for (int i = 0; i < m_posts.size(); ++i) {
-            m_feedLayout->addWidget(createPostCard(m_posts[i], i));
+        if (shown >= 0 && shown < message.index) {
+            break;
         }
-        
-        // Load profile data
-        m_userProfile = loadUserProfile();
-        m_profileUsername->setText("@" + m_userProfile.username);
-        m_profileStats->setText(QString("%1 Followers • %2 Following")
-                                .arg(m_userProfile.followerCount)
-                                .arg(m_userProfile.followingCount));
-        
-        // Switch to feed page
-        m_stackedWidget->setCurrentWidget(m_feedPage);
-        
-        QMessageBox::information(this, "Welcome!", 
-            QString("Welcome back, %1! 🎉").arg(username));
-    } else {
-        QMessageBox::critical(this, "Login Failed", 
-            "Invalid username or password. Please try again.");
+    }
+    
+    // Bubble on the next frame
+    Message msg;
+    msg.sender = message.from;
+    msg.content = message.text;
+    msg.sentAt = message.sentAt;
+    msg.isOutgoing = false;
+    msg.index = message.index;
+    m_messages.append(msg);
+    m_messagesEnd = qMax(m_messagesEnd, message.index + 1);
+    
+    if (!m_incomingFlushTimer->isActive()) {
+        m_incomingFlushTimer->start();
     }
 }
 
-void MainWindow::showFeed()
+void MainWindow::flushIncomingMessages()
 {
-    m_stackedWidget->setCurrentWidget(m_feedPage);
+    // The layout holds exactly one bubble per row already shown
+    int row = m_messagesLayout->count();
+    if (row == m_messages.size()) {
+        return;
+    }
+    
+    // One layout pass and repaint for the whole batch
+    QWidget* container = m_messagesScrollArea->widget();
+    container->setUpdatesEnabled(false);
+    for (; row < m_messages.size(); ++row) {
+        m_messagesLayout->addWidget(createMessageBubble(row));
+    }
+    container->setUpdatesEnabled(true);
 }
 
-void MainWindow::showMessages()
+void MainWindow::refreshTimeLabels()
 {
-    // Load messages
-    m_messages = loadMessages();
+    // Re-armed each time so the timer cannot drift off the minute
+    m_timeLabelTimer->start(TimeFormatter::msecsToNextMinute());
+    if (!TimeFormatter::advance()) {
+        return;
+    }
     
-    // Clear existing messages
-    QLayoutItem* item;
-    while ((item = m_messagesLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
+    // One dataChanged per model; the views repaint only visible cards
+    if (m_feedModel) {
+        m_feedModel->refreshTimestamps();
+        m_searchModel->refreshTimestamps();
+    }
+    if (m_storyModel) {
+        m_storyModel->refreshTimestamps();
+    }
+    if (m_notificationsList) {
+        for (int row = 0; row < m_notificationsList->count(); ++row) {
+            QListWidgetItem* item = m_notificationsList->item(row);
+            if (item->data(NotificationTimeRole).isValid()) {
+                setNotificationLabel(item);
+            }
+        }
+    }
+}
+
+void MainWindow::onUserProfileLoaded(const User& profile)
+{
+    Trace::Scope scope("onUserProfileLoaded");
+    ensurePage(ProfilePage);
+    m_userProfile = profile;
+    m_profileUsername->setText("@" + m_userProfile.username);
+    m_profileAvatar->setText("👤");   // Clears the last user's picture
+    m_images->load(m_profileAvatar, m_userProfile.avatarPath.isEmpty()
+                       ? ImageCache::avatarPath(m_userProfile.username) : m_userProfile.avatarPath,
+                   QSize(112, 112), ImageCache::Circle);
+    m_profileStats->setText(QString("%1 Followers • %2 Following")
+                            .arg(m_userProfile.followerCount)
+                            .arg(m_userProfile.followingCount));
+}
+
+void MainWindow::onPostCreated(bool ok)
+{
+    if (!ok) {
+        QMessageBox::warning(this, "Post Failed", "Your post could not be saved. Please try again.");
+        return;
+    }
+    reloadFeed();
+}
+
+void MainWindow::onStoryRingsLoaded(const StoryRingList& rings)
+{
+    if (rings.username != m_currentUser) {
+        return;
+    }
+    m_storyModel->setRings(rings.rings);
+}
+
+void MainWindow::openStory(const QModelIndex& index)
+{
+    const StoryRing& ring = m_storyModel->ringAt(index.row());
+    if (ring.storyCount == 0) {
+        // Own circle without a story: share one from the composer
+        m_postInput->setFocus();
+        return;
     }
     
-    // Populate messages
-    for (const Message& msg : m_messages) {
-        m_messagesLayout->addWidget(createMessageBubble(msg));
+    // Stories are only fetched when their circle is opened
+    m_storyModel->markSeen(index.row());
+    m_backend->requestStories(m_currentUser, ring.username);
+}
+
+void MainWindow::onStoriesLoaded(const StoryPage& page)
+{
+    if (page.viewer != m_currentUser) {
+        return;
+    }
+    if (page.stories.isEmpty()) {
+        // Expired since the bar was loaded
+        m_backend->requestStoryRings(m_currentUser);
+        return;
     }
     
-    m_stackedWidget->setCurrentWidget(m_messagesPage);
+    QStringList lines;
+    for (const Story& story : page.stories) {
+        lines.append(QString("%1  (%2)").arg(story.caption, TimeFormatter::relative(story.createdAt)));
+    }
+    QMessageBox::information(this, QString("@%1's story").arg(page.author), lines.join("\n\n"));
+}
+
+void MainWindow::onStoryCreated(bool ok)
+{
+    if (!ok) {
+        QMessageBox::warning(this, "Story Failed", "Your story could not be saved. Please try again.");
+        return;
+    }
+    m_backend->requestStoryRings(m_currentUser);
+}
+
+void MainWindow::onMutationLogFailed(const QString& error)
+{
+    QMessageBox::warning(this, "Changes Not Saved",
+                         QString("Changes can no longer be saved to disk (%1). Anything you do now "
+                                 "will be lost when the app closes.").arg(error));
+}
+
+void MainWindow::onNotificationsLoaded(const NotificationList& notifications)
+{
+    if (notifications.username != m_currentUser) {
+        return;
+    }
     
-    // Scroll to bottom
-    QTimer::singleShot(100, [this]() {
-        m_messagesScrollArea->verticalScrollBar()->setValue(
-            m_messagesScrollArea->verticalScrollBar()->maximum()
-        );
-    });
+    ensurePage(NotificationsPage);
+    m_notificationsList->clear();
+    bool anyUnread = false;
+    auto addSection = [this, &anyUnread](const QString& title, const QVector<Notification>& rows) {
+        if (rows.isEmpty()) {
+            return;
+        }
+        QListWidgetItem* heading = new QListWidgetItem(title, m_notificationsList);
+        QFont headingFont = heading->font();
+        headingFont.setBold(true);
+        heading->setFont(headingFont);
+        heading->setFlags(Qt::NoItemFlags);
+        
+        for (const Notification& row : rows) {
+            QListWidgetItem* item = new QListWidgetItem(m_notificationsList);
+            item->setData(NotificationTextRole, QString("%1%2").arg(row.isPriority ? "⭐ " : "", row.text));
+            item->setData(NotificationTimeRole, row.updatedAt);
+            setNotificationLabel(item);
+            if (row.isUnread) {
+                QFont unreadFont = item->font();
+                unreadFont.setBold(true);
+                item->setFont(unreadFont);
+                anyUnread = true;
+            }
+        }
+    };
+    addSection("⭐ Priority (Close Friends)", notifications.priority);
+    addSection("Other", notifications.regular);
+    
+    if (m_notificationsList->count() == 0) {
+        new QListWidgetItem("No notifications", m_notificationsList);
+    }
+    
+    // Seen now that they are on screen
+    if (anyUnread && m_stackedWidget->currentWidget() == m_notificationsPage) {
+        m_backend->markNotificationsRead(m_currentUser);
+    }
+}
+
+void MainWindow::onNotificationsChanged(const QString& username, int unread, int priorityUnread)
+{
+    if (username != m_currentUser) {
+        return;
+    }
+    m_notificationsButton->setText(badgeText(unread, priorityUnread));
+    
+    // Keep an open list current
+    if (m_stackedWidget->currentWidget() == m_notificationsPage) {
+        m_backend->requestNotifications(m_currentUser, NotificationLimit);
+    }
+}
+
+void MainWindow::onCloseFriendStatusSaved(bool status)
+{
+    Q_UNUSED(status);
+    
+    // Close Friends Mode changes which authors the feed draws from
+    if (!m_currentUser.isEmpty()) {
+        reloadFeed();
+    }
+}
+
+void MainWindow::showFeed()
+{
+    ensurePage(FeedPage);
+    m_stackedWidget->setCurrentWidget(m_feedPage);
+}
+
+void MainWindow::showMessages()
+{
+    // Show what we already have at once, then refresh in the background
+    ensurePage(MessagesPage);
+    m_stackedWidget->setCurrentWidget(m_messagesPage);
+    m_backend->requestMessages(m_currentUser, ChatPartner, MessagePageSize);
 }
 
 void MainWindow::showProfile()
 {
+    ensurePage(ProfilePage);
     m_stackedWidget->setCurrentWidget(m_profilePage);
+    m_backend->requestUserProfile(m_currentUser);
+}
+
+void MainWindow::showNotifications()
+{
+    // Marked read once the list has been shown (onNotificationsLoaded)
+    ensurePage(NotificationsPage);
+    m_stackedWidget->setCurrentWidget(m_notificationsPage);
+    m_backend->requestNotifications(m_currentUser, NotificationLimit);
 }
 
 void MainWindow::likePost(int postIndex)
 {
-    if (postIndex >= 0 && postIndex < m_posts.size()) {
-        // TODO: Call backend to save like
-        // Example: like_post_c(m_posts[postIndex].postId, current_user);
+    // Rows index whichever model the view shows (feed or search results)
+    FeedModel* model = m_feedView->model() == m_searchModel ? m_searchModel : m_feedModel;
+    if (postIndex >= 0 && postIndex < model->rowCount()) {
+        // Logged to the WAL; durable with the next group commit
+        const quint64 postId = model->posts().postId(postIndex);
+        m_backend->likePost(m_currentUser, postId);
         
-        m_posts[postIndex].likes++;
-        
-        // Refresh the feed to show updated like count
-        QWidget* oldCard = m_feedLayout->itemAt(postIndex)->widget();
-        QWidget* newCard = createPostCard(m_posts[postIndex], postIndex);
-        m_feedLayout->replaceWidget(oldCard, newCard);
-        delete oldCard;
+        // The post may be loaded in both the feed and the search results;
+        // each model notifies its view, which repaints just that row
+        for (FeedModel* loaded : { m_feedModel, m_searchModel }) {
+            loaded->incrementLikes(loaded == model ? postIndex : loaded->posts().indexOf(postId));
+        }
         
-        qDebug() << "Liked post by" << m_posts[postIndex].username;
+        Trace::count("likes");
+    }
+}
+
+void MainWindow::createStory()
+{
+    const QString caption = m_postInput->text().trimmed();
+    if (caption.isEmpty() || m_currentUser.isEmpty()) {
+        m_postInput->setFocus();
+        return;
     }
+    
+    // Visible for 24 hours; the bar reloads once it is stored
+    m_backend->createStory(m_currentUser, caption);
+    m_postInput->clear();
+}
+
+void MainWindow::createPost()
+{
+    const QString content = m_postInput->text().trimmed();
+    if (content.isEmpty() || m_currentUser.isEmpty()) {
+        return;
+    }
+    
+    // Fanned out to followers' timelines on the backend; the feed reloads
+    // once it is in ours
+    m_backend->createPost(m_currentUser, content);
+    m_postInput->clear();
 }
 
 void MainWindow::sendMessage()
@@ -821,33 +1287,34 @@ void MainWindow::sendMessage()
         return;
     }
     
-    // TODO: Call backend to save message
-    // Example: send_message_c(current_user, recipient, messageText.toStdString().c_str());
+    // Logged to the WAL on the backend's writer; durable with the next
+    // group commit. Pushed to the partner, if online, once stored.
+    const int ticket = ++m_nextMessageTicket;
+    m_backend->sendMessage(m_currentUser, ChatPartner, messageText, ticket);
+    m_unpublished.insert(ticket, messageText);
     
-    // Create message object
+    // Create message object (its position arrives with messageStored())
     Message newMsg;
     newMsg.sender = "You";
     newMsg.content = messageText;
-    newMsg.timestamp = QTime::currentTime().toString("h:mm AP");
+    newMsg.sentAt = QDateTime::currentSecsSinceEpoch();
     newMsg.isOutgoing = true;
     
-    // Add to messages list
+    // Add to messages list, after any pushed messages still queued
     m_messages.append(newMsg);
+    if (m_messagesSynced) {
+        m_unstoredRows.insert(ticket, m_messages.size() - 1);
+    }
     
-    // Add to UI
-    m_messagesLayout->addWidget(createMessageBubble(newMsg));
+    // Add to UI; the range change scrolls it into view
+    m_messagesStickToBottom = true;
+    m_messagesAnchor = -1;
+    flushIncomingMessages();
     
     // Clear input
     m_messageInput->clear();
     
-    // Scroll to bottom
-    QTimer::singleShot(50, [this]() {
-        m_messagesScrollArea->verticalScrollBar()->setValue(
-            m_messagesScrollArea->verticalScrollBar()->maximum()
-        );
-    });
-    
-    qDebug() << "Message sent:" << messageText;
+    Trace::count("messages sent");
 }
 
 
@@ -0,0 +1,193 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "datatypes.h"
+#include "messagebus.h"
+#include "messagetable.h"
+
+class QStackedWidget;
+class QWidget;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QScrollArea;
+class QListView;
+class QListWidget;
+class QVBoxLayout;
+class FeedModel;
+class PostCardDelegate;
+class StoryModel;
+class StoryDelegate;
+class ImageCache;
+class BackendService;
+class MessageBusClient;
+class QTimer;
+class QEvent;
+
+// ============================================================================
+// MAIN WINDOW
+// ============================================================================
+
+class MainWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    explicit MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void buildNextPage();
+    void handleLogin();
+    void handleSignUp();
+    void showFeed();
+    void showMessages();
+    void showProfile();
+    void showNotifications();
+    void likePost(int postIndex);
+    void sendMessage();
+    void createPost();
+    void createStory();
+    void openStory(const QModelIndex& index);
+    void searchPosts(const QString& query);
+    void maybeFetchNextFeedPage();
+    void onMessagesScrolled(int value);
+    void onMessagesRangeChanged(int min, int max);
+
+    // Backend results (queued from worker threads)
+    void onAuthenticated(const QString& username, bool ok, const QByteArray& sessionToken);
+    void onFeedPageLoaded(const FeedPage& page);
+    void onMessagesLoaded(const MessagePage& page);
+    void onUserProfileLoaded(const User& profile);
+    void onCloseFriendStatusSaved(bool status);
+    void onMessageStored(int ticket, int index);
+    void onPostCreated(bool ok);
+    void onNotificationsLoaded(const NotificationList& notifications);
+    void onNotificationsChanged(const QString& username, int unread, int priorityUnread);
+    void onSearchResultsLoaded(const SearchResults& results);
+    void onStoryRingsLoaded(const StoryRingList& rings);
+    void onStoriesLoaded(const StoryPage& page);
+    void onStoryCreated(bool ok);
+    void onMutationLogFailed(const QString& error);
+
+    // Message bus pushes (batched per frame)
+    void onBusMessage(const BusMessage& message);
+    // Bubbles for the rows appended since the last frame
+    void flushIncomingMessages();
+
+    // Once a minute, on the minute: every relative time label in one batch
+    void refreshTimeLabels();
+
+private:
+    enum Page {
+        FeedPage,
+        MessagesPage,
+        ProfilePage,
+        NotificationsPage
+    };
+
+    // Pages past the login screen are built on first use, or one per idle
+    // turn once the login screen has been painted
+    void ensurePage(Page page);
+
+    // Login and sign-up share the form; the result arrives in onAuthenticated
+    void submitCredentials(bool createAccount);
+
+    // Page setup
+    void setupLoginPage();
+    void setupFeedPage();
+    void setupMessagesPage();
+    void setupProfilePage();
+    void setupNotificationsPage();
+
+    // Widget creation helpers
+    QWidget* createMessageBubble(int row);   // Row of m_messages
+    void clearMessagesView();
+    void prependOlderMessages(const MessagePage& page);
+    void reloadFeed();
+
+    // Backend integration
+    void saveCloseFriendStatus(bool status);
+
+    QStackedWidget* m_stackedWidget;
+    BackendService* m_backend;
+    MessageBusClient* m_bus;
+    ImageCache* m_images;   // Avatars, story circles, post media (decoded off-thread)
+
+    // Pages
+    QWidget* m_loginPage = nullptr;
+    QWidget* m_feedPage = nullptr;
+    QWidget* m_messagesPage = nullptr;
+    QWidget* m_profilePage = nullptr;
+    QWidget* m_notificationsPage = nullptr;
+
+    // Login page
+    QLineEdit* m_usernameInput = nullptr;
+    QLineEdit* m_passwordInput = nullptr;
+
+    // Stories bar (model/view: only visible circles are painted)
+    QListView* m_storiesView = nullptr;
+    StoryModel* m_storyModel = nullptr;
+    StoryDelegate* m_storyDelegate = nullptr;
+
+    // Feed page (model/view: only visible cards are painted)
+    QListView* m_feedView = nullptr;
+    FeedModel* m_feedModel = nullptr;
+    PostCardDelegate* m_feedDelegate = nullptr;
+    QByteArray m_feedCursor;
+    bool m_feedAtEnd = true;
+    bool m_feedPageLoading = false;
+    int m_feedGeneration = 0;
+    QLineEdit* m_postInput = nullptr;
+    QPushButton* m_notificationsButton = nullptr;   // Shows the unread badge
+
+    // Search (results swap into the feed view while there is a query)
+    QLineEdit* m_searchInput = nullptr;
+    QLabel* m_searchUsersLabel = nullptr;
+    FeedModel* m_searchModel = nullptr;
+    int m_searchGeneration = 0;
+
+    // Messages page (bubbles for conversation positions [first, end); one
+    // per m_messages row, except rows pushed since the last frame)
+    QScrollArea* m_messagesScrollArea = nullptr;
+    QVBoxLayout* m_messagesLayout = nullptr;
+    QLineEdit* m_messageInput = nullptr;
+    MessageTable m_messages;
+    int m_messagesFirst = 0;
+    int m_messagesEnd = 0;
+    bool m_messagesSynced = false;          // Newest page loaded since login
+    bool m_messagesLoadingOlder = false;
+    bool m_messagesStickToBottom = true;    // Follow new messages
+    int m_messagesAnchor = -1;              // Distance from bottom kept while history is prepended
+    QHash<int, int> m_unstoredRows;         // Ticket -> row of a sent message not yet stored
+    QHash<int, QString> m_unpublished;      // Ticket -> text, pushed to the partner once stored
+    int m_nextMessageTicket = 0;
+    QTimer* m_incomingFlushTimer = nullptr;
+    QTimer* m_timeLabelTimer = nullptr;
+
+    // Profile page
+    QLabel* m_profileAvatar = nullptr;
+    QLabel* m_profileUsername = nullptr;
+    QLabel* m_profileStats = nullptr;
+    QPushButton* m_closeFriendToggle = nullptr;
+
+    // Notifications page
+    QListWidget* m_notificationsList = nullptr;
+
+    // Session state
+    QString m_currentUser;
+    bool m_authPending = false;
+    bool m_signUpPending = false;   // The pending request creates an account
+    QByteArray m_sessionToken;
+    User m_userProfile;
+};
+
+#endif // MAINWINDOW_H
@@ -0,0 +1,133 @@
+#include "messagebroker.h"
+#include "messagebus.h"
+#include "credentialstore.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtEndian>
+
+MessageBroker::MessageBroker(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+{
+    connect(m_server, &QLocalServer::newConnection, this, &MessageBroker::onNewConnection);
+}
+
+MessageBroker::~MessageBroker()
+{
+    m_server->close();
+}
+
+bool MessageBroker::listen(const QString& serverName, const QByteArray& sessionKey)
+{
+    m_sessionKey = sessionKey;
+    
+    // Refuse to steal the name from a broker that is still running
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if (probe.waitForConnected(100)) {
+        m_error = QString("a broker is already listening on %1").arg(serverName);
+        return false;
+    }
+    
+    // Socket file left behind by a broker that crashed
+    QLocalServer::removeServer(serverName);
+    
+    // Other OS users cannot even connect
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(serverName)) {
+        m_error = m_server->errorString();
+        return false;
+    }
+    return true;
+}
+
+void MessageBroker::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, Client());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { onDisconnected(socket); });
+    }
+}
+
+void MessageBroker::onReadyRead(QLocalSocket* socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    it->buffer.append(socket->readAll());
+    
+    bool rejected = false;
+    MessageBus::readFrames(it->buffer, [this, socket, &rejected](quint8 type, const QByteArray& body) {
+        if (rejected) {
+            return;
+        }
+        if (type == MessageBus::Publish) {
+            route(socket, body);
+        } else if (type == MessageBus::Subscribe) {
+            QString username;
+            QByteArray sessionToken;
+            if (!MessageBus::decodeSubscribe(body, &username, &sessionToken)
+                || !CredentialStore::checkSessionToken(m_sessionKey, username, sessionToken)) {
+                rejected = true;
+                return;
+            }
+            Client& client = m_clients[socket];
+            if (!client.username.isEmpty()) {
+                m_subscribers[client.username].removeAll(socket);
+            }
+            client.username = username;
+            m_subscribers[username].append(socket);
+        }
+    });
+    
+    // Dropped only after readFrames() is done with the client's buffer;
+    // onDisconnected() then forgets the client
+    if (rejected) {
+        ++m_rejected;
+        socket->abort();
+    }
+}
+
+void MessageBroker::onDisconnected(QLocalSocket* socket)
+{
+    const Client client = m_clients.take(socket);
+    if (!client.username.isEmpty()) {
+        QVector<QLocalSocket*>& sockets = m_subscribers[client.username];
+        sockets.removeAll(socket);
+        if (sockets.isEmpty()) {
+            m_subscribers.remove(client.username);
+        }
+    }
+    socket->deleteLater();
+}
+
+void MessageBroker::route(QLocalSocket* sender, const QByteArray& body)
+{
+    // Only the header fields are checked; the frame is forwarded byte for byte
+    BusMessage message;
+    if (!MessageBus::decodeMessage(body, &message)) {
+        return;
+    }
+    if (message.from.isEmpty() || message.from != m_clients.value(sender).username) {
+        ++m_rejected;   // Not subscribed, or publishing as someone else
+        return;
+    }
+    auto it = m_subscribers.constFind(message.to);
+    if (it == m_subscribers.constEnd()) {
+        return;   // Recipient offline: live delivery only, nothing is queued
+    }
+    
+    QByteArray frame(4, '\0');
+    qToLittleEndian<quint32>(quint32(body.size() + 1), frame.data());
+    frame.append(char(MessageBus::Publish));
+    frame.append(body);
+    
+    for (QLocalSocket* socket : it.value()) {
+        if (socket != sender) {
+            socket->write(frame);
+            ++m_routed;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef MESSAGEBROKER_H
+#define MESSAGEBROKER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QLocalServer;
+class QLocalSocket;
+
+// ============================================================================
+// MESSAGE BROKER
+// Pub/sub hub for MessageBusClient connections on one machine. A client
+// subscribes with its username and the session token from its login; every
+// published message is pushed to all connections subscribed as its
+// recipient. Frames are routed as received (only the header is decoded),
+// and all sockets are served from one event loop, so a broker process
+// comfortably fans out thousands of messages per second. See messagebus.h
+// for the wire format.
+//
+// Only the current OS user can connect. A subscription needs a token signed
+// with the users.dat session key (see CredentialStore), a bad one drops the
+// connection, and a publish is routed only if its sender is the username
+// the connection subscribed as.
+// ============================================================================
+
+class MessageBroker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MessageBroker(QObject *parent = nullptr);
+    ~MessageBroker();
+
+    // sessionKey checks subscription tokens (CredentialStore::loadSessionKey)
+    bool listen(const QString& serverName, const QByteArray& sessionKey);
+    QString errorString() const { return m_error; }
+
+    int clientCount() const { return m_clients.size(); }
+    quint64 routedCount() const { return m_routed; }
+    quint64 rejectedCount() const { return m_rejected; }
+
+private slots:
+    void onNewConnection();
+
+private:
+    struct Client {
+        QString username;
+        QByteArray buffer;
+    };
+
+    void onReadyRead(QLocalSocket* socket);
+    void onDisconnected(QLocalSocket* socket);
+    void route(QLocalSocket* sender, const QByteArray& body);
+
+    QLocalServer* m_server;
+    QHash<QLocalSocket*, Client> m_clients;
+    QHash<QString, QVector<QLocalSocket*>> m_subscribers;
+    QByteArray m_sessionKey;
+    quint64 m_routed = 0;
+    quint64 m_rejected = 0;   // Bad subscriptions and spoofed publishes
+    QString m_error;
+};
+
+#endif // MESSAGEBROKER_H
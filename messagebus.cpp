@@ -0,0 +1,204 @@
+#include "messagebus.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QtEndian>
+#include <chrono>
+
+namespace {
+
+const int FrameHeaderSize = 4;                 // quint32 length
+const quint32 MaxFrameSize = 1024 * 1024;      // Anything larger is a broken stream
+const int ReconnectDelayMs = 1000;
+
+QByteArray frame(MessageBus::FrameType type, const std::function<void(QDataStream&)>& fields)
+{
+    QByteArray bytes(FrameHeaderSize, '\0');
+    bytes.append(char(type));
+    {
+        QDataStream out(&bytes, QIODevice::WriteOnly | QIODevice::Append);
+        out.setVersion(QDataStream::Qt_5_12);
+        fields(out);
+    }
+    qToLittleEndian<quint32>(quint32(bytes.size() - FrameHeaderSize), bytes.data());
+    return bytes;
+}
+
+} // namespace
+
+// ============================================================================
+// PROTOCOL
+// ============================================================================
+
+namespace MessageBus {
+
+const char* const DefaultServerName = "priority-social-bus";
+
+qint64 monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QByteArray subscribeFrame(const QString& username, const QByteArray& sessionToken)
+{
+    return frame(Subscribe, [&](QDataStream& out) { out << username << sessionToken; });
+}
+
+QByteArray messageFrame(const BusMessage& message)
+{
+    return frame(Publish, [&](QDataStream& out) {
+        out << message.from << message.to << message.text << message.sentAt << message.publishedNs
+            << message.index;
+    });
+}
+
+bool decodeSubscribe(const QByteArray& body, QString* username, QByteArray* sessionToken)
+{
+    QDataStream in(body);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> *username >> *sessionToken;
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeMessage(const QByteArray& body, BusMessage* message)
+{
+    QDataStream in(body);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> message->from >> message->to >> message->text >> message->sentAt >> message->publishedNs
+       >> message->index;
+    return in.status() == QDataStream::Ok;
+}
+
+void readFrames(QByteArray& buffer, const FrameHandler& handler)
+{
+    int offset = 0;
+    while (buffer.size() - offset >= FrameHeaderSize) {
+        const quint32 length = qFromLittleEndian<quint32>(buffer.constData() + offset);
+        if (length == 0 || length > MaxFrameSize) {
+            buffer.clear();   // Out of sync: drop the stream contents
+            return;
+        }
+        if (quint32(buffer.size() - offset - FrameHeaderSize) < length) {
+            break;   // Partial frame; wait for more bytes
+        }
+        const char* body = buffer.constData() + offset + FrameHeaderSize;
+        handler(quint8(body[0]), QByteArray::fromRawData(body + 1, int(length) - 1));
+        offset += FrameHeaderSize + int(length);
+    }
+    buffer.remove(0, offset);
+}
+
+} // namespace MessageBus
+
+// ============================================================================
+// CLIENT
+// ============================================================================
+
+MessageBusClient::MessageBusClient(QObject *parent)
+    : QObject(parent)
+    , m_socket(new QLocalSocket(this))
+    , m_reconnectTimer(new QTimer(this))
+{
+    qRegisterMetaType<BusMessage>("BusMessage");
+
+    m_reconnectTimer->setSingleShot(true);
+    m_reconnectTimer->setInterval(ReconnectDelayMs);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &MessageBusClient::reconnect);
+
+    connect(m_socket, &QLocalSocket::connected, this, &MessageBusClient::onConnected);
+    connect(m_socket, &QLocalSocket::disconnected, this, &MessageBusClient::onDisconnected);
+    connect(m_socket, &QLocalSocket::readyRead, this, &MessageBusClient::onReadyRead);
+    connect(m_socket, &QLocalSocket::errorOccurred, this, [this]() {
+        // Broker not running yet: try again later
+        if (m_socket->state() == QLocalSocket::UnconnectedState && !m_username.isEmpty()) {
+            m_reconnectTimer->start();
+        }
+    });
+}
+
+MessageBusClient::~MessageBusClient()
+{
+    stop();
+}
+
+void MessageBusClient::start(const QString& username, const QByteArray& sessionToken,
+                             const QString& serverName)
+{
+    m_username = username;
+    m_sessionToken = sessionToken;
+    m_serverName = serverName;
+    reconnect();
+}
+
+void MessageBusClient::stop()
+{
+    m_username.clear();
+    m_sessionToken.clear();
+    m_reconnectTimer->stop();
+    m_socket->abort();
+    m_buffer.clear();
+}
+
+bool MessageBusClient::isConnected() const
+{
+    return m_socket->state() == QLocalSocket::ConnectedState;
+}
+
+bool MessageBusClient::publish(const QString& to, const QString& text, int index)
+{
+    BusMessage message;
+    message.from = m_username;
+    message.to = to;
+    message.text = text;
+    message.sentAt = QDateTime::currentSecsSinceEpoch();
+    message.publishedNs = MessageBus::monotonicNs();
+    message.index = index;
+    return publish(message);
+}
+
+bool MessageBusClient::publish(const BusMessage& message)
+{
+    // Live delivery only; the message is already stored on the sender side
+    if (!isConnected()) {
+        return false;
+    }
+    const QByteArray bytes = MessageBus::messageFrame(message);
+    return m_socket->write(bytes) == bytes.size();
+}
+
+void MessageBusClient::onConnected()
+{
+    m_buffer.clear();
+    m_socket->write(MessageBus::subscribeFrame(m_username, m_sessionToken));
+    emit connectedChanged(true);
+}
+
+void MessageBusClient::onDisconnected()
+{
+    emit connectedChanged(false);
+    if (!m_username.isEmpty()) {
+        m_reconnectTimer->start();
+    }
+}
+
+void MessageBusClient::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+    MessageBus::readFrames(m_buffer, [this](quint8 type, const QByteArray& body) {
+        BusMessage message;
+        if (type == MessageBus::Publish && MessageBus::decodeMessage(body, &message)) {
+            emit messageReceived(message);
+        }
+    });
+}
+
+void MessageBusClient::reconnect()
+{
+    if (m_username.isEmpty()) {
+        return;
+    }
+    m_socket->abort();
+    m_socket->connectToServer(m_serverName);
+}
@@ -0,0 +1,104 @@
+#ifndef MESSAGEBUS_H
+#define MESSAGEBUS_H
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <functional>
+
+class QLocalSocket;
+class QTimer;
+
+// ============================================================================
+// MESSAGE BUS (client side)
+// Local stand-in for the push transport: clients connect to the broker
+// process (MessageBroker) over a local socket (Unix domain socket, named
+// pipe on Windows), subscribe with their username and login session token
+// and publish chat messages. The broker pushes each message to the
+// recipient's connections, so nothing polls. Clients share one data
+// directory: the sender stores a message before publishing it, with its
+// conversation position, and the recipient only displays it.
+//
+// Wire format, both directions (little-endian):
+//   quint32 length, then a QDataStream body: quint8 type, fields
+//   Subscribe: username, sessionToken
+//   Publish:   from, to, text, sentAt, publishedNs, index
+// ============================================================================
+
+struct BusMessage {
+    QString from;
+    QString to;
+    QString text;
+    qint64 sentAt = 0;        // Seconds since epoch
+    qint64 publishedNs = 0;   // Monotonic clock at publish, for latency tracing
+    qint32 index = -1;        // Position in the conversation (-1 = not stored)
+};
+
+Q_DECLARE_METATYPE(BusMessage)
+
+namespace MessageBus {
+
+enum FrameType : quint8 {
+    Subscribe = 1,
+    Publish = 2   // Client to broker and broker to subscribers
+};
+
+extern const char* const DefaultServerName;
+
+// Monotonic nanoseconds, comparable across processes on one host
+qint64 monotonicNs();
+
+QByteArray subscribeFrame(const QString& username, const QByteArray& sessionToken);
+QByteArray messageFrame(const BusMessage& message);
+
+bool decodeSubscribe(const QByteArray& body, QString* username, QByteArray* sessionToken);
+bool decodeMessage(const QByteArray& body, BusMessage* message);
+
+// Splits buffered socket bytes into frames, calls handler(type, body) for
+// each complete one and keeps any partial tail for the next read
+using FrameHandler = std::function<void(quint8 type, const QByteArray& body)>;
+void readFrames(QByteArray& buffer, const FrameHandler& handler);
+
+} // namespace MessageBus
+
+class MessageBusClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MessageBusClient(QObject *parent = nullptr);
+    ~MessageBusClient();
+
+    // Connects (and keeps reconnecting) to the broker, subscribed as username;
+    // the token from login proves it
+    void start(const QString& username, const QByteArray& sessionToken,
+               const QString& serverName = MessageBus::DefaultServerName);
+    void stop();
+    bool isConnected() const;
+
+    // False when not connected (live delivery only, nothing is queued).
+    // index is the message's position once the sender has stored it.
+    bool publish(const QString& to, const QString& text, int index = -1);
+    bool publish(const BusMessage& message);
+
+signals:
+    void messageReceived(const BusMessage& message);
+    void connectedChanged(bool connected);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+    void reconnect();
+
+private:
+    QLocalSocket* m_socket;
+    QTimer* m_reconnectTimer;
+    QString m_username;
+    QByteArray m_sessionToken;
+    QString m_serverName;
+    QByteArray m_buffer;
+};
+
+#endif // MESSAGEBUS_H
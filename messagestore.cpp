@@ -0,0 +1,298 @@
+#include "messagestore.h"
+#include <QByteArray>
+#include <QDataStream>
+#include <QLockFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char MessageStoreMagic[8] = { 'P', 'S', 'M', 'S', 'G', 'S', '0', '1' };
+const quint32 MessageStoreVersion = 1;
+const int FrameHeaderSize = 4;                     // quint32 length
+const quint32 MaxFrameSize = 16 * 1024 * 1024;     // Anything larger is corruption
+
+static_assert(sizeof(MessageStoreHeader) == 16, "messages.dat header layout changed");
+
+QByteArray encode(const StoredMessage& message)
+{
+    QByteArray body;
+    QDataStream out(&body, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << message.sequence << message.sentAt << message.from << message.to << message.text;
+    return body;
+}
+
+bool decode(const QByteArray& body, StoredMessage* message)
+{
+    QDataStream in(body);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> message->sequence >> message->sentAt >> message->from >> message->to >> message->text;
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+MessageStore::MessageStore()
+{
+}
+
+MessageStore::~MessageStore()
+{
+    close();
+}
+
+bool MessageStore::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    // Another client may be creating the file or appending to it (close()
+    // releases the lock on failure)
+    m_lock.reset(new QLockFile(path + ".lock"));
+    if (!m_lock->lock()) {
+        m_error = QString("%1.lock could not be taken").arg(path);
+        close();
+        return false;
+    }
+
+    // New file: write the header
+    if (m_file.size() == 0) {
+        MessageStoreHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MessageStoreMagic, sizeof(MessageStoreMagic));
+        header.version = qToLittleEndian(MessageStoreVersion);
+        if (m_file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)
+            || !m_file.flush()) {
+            m_error = m_file.errorString();
+            close();
+            return false;
+        }
+    }
+
+    MessageStoreHeader header;
+    if (!m_file.seek(0)
+        || m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+        || std::memcmp(header.magic, MessageStoreMagic, sizeof(MessageStoreMagic)) != 0
+        || qFromLittleEndian(header.version) != MessageStoreVersion) {
+        m_error = "messages.dat has an invalid header";
+        close();
+        return false;
+    }
+
+    // Single pass to rebuild the indexes. A torn tail (crash mid-append) is
+    // cut off; the write-ahead log replays whatever it held.
+    m_end = scan(sizeof(MessageStoreHeader));
+    if (m_end < m_file.size() && !m_file.resize(m_end)) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+    m_lock->unlock();
+
+    m_error.clear();
+    return true;
+}
+
+void MessageStore::refresh()
+{
+    if (isOpen() && m_file.size() > m_end) {
+        m_end = scan(m_end);
+    }
+}
+
+qint64 MessageStore::scan(qint64 offset)
+{
+    // Stops at the first incomplete or unreadable frame
+    const qint64 fileSize = m_file.size();
+    if (!m_file.seek(offset)) {
+        return offset;
+    }
+    while (offset + FrameHeaderSize <= fileSize) {
+        uchar lengthBytes[FrameHeaderSize];
+        if (m_file.read(reinterpret_cast<char*>(lengthBytes), FrameHeaderSize) != FrameHeaderSize) {
+            break;
+        }
+        const quint32 length = qFromLittleEndian<quint32>(lengthBytes);
+        if (length > MaxFrameSize || offset + FrameHeaderSize + length > fileSize) {
+            break;
+        }
+
+        StoredMessage message;
+        if (!decode(m_file.read(length), &message)) {
+            break;
+        }
+        index(offset, message);
+        offset += FrameHeaderSize + length;
+    }
+    return offset;
+}
+
+void MessageStore::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_lock.reset();
+    m_end = 0;
+    m_count = 0;
+    m_lastSequence = 0;
+    m_sequences.clear();
+    m_conversations.clear();
+    m_inboxes.clear();
+}
+
+bool MessageStore::append(const StoredMessage& message)
+{
+    if (!isOpen()) {
+        m_error = "messages.dat is not open";
+        return false;
+    }
+    if (!m_lock->lock()) {
+        m_error = "messages.dat.lock could not be taken";
+        return false;
+    }
+
+    // Other clients' frames first, so positions count them. Nobody else is
+    // writing now, so anything left past them is a torn frame to cut.
+    refresh();
+    if (message.sequence != 0 && m_sequences.contains(message.sequence)) {
+        m_lock->unlock();
+        return true;   // Already stored before the log was replayed
+    }
+
+    const QByteArray body = encode(message);
+    uchar lengthBytes[FrameHeaderSize];
+    qToLittleEndian<quint32>(quint32(body.size()), lengthBytes);
+
+    // No fsync here: the write-ahead log is the durable copy
+    const qint64 offset = m_end;
+    const bool ok = (m_file.size() == offset || m_file.resize(offset))
+        && m_file.seek(offset)
+        && m_file.write(reinterpret_cast<const char*>(lengthBytes), FrameHeaderSize) == FrameHeaderSize
+        && m_file.write(body) == body.size()
+        && m_file.flush();
+    m_lock->unlock();
+    if (!ok) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    index(offset, message);
+    m_end = offset + FrameHeaderSize + body.size();
+    return true;
+}
+
+int MessageStore::conversationSize(const QString& a, const QString& b) const
+{
+    auto it = m_conversations.constFind(conversationKey(a, b));
+    return it == m_conversations.constEnd() ? 0 : it->offsets.size();
+}
+
+QVector<StoredMessage> MessageStore::conversation(const QString& a, const QString& b,
+                                                  int limit, int end)
+{
+    QVector<StoredMessage> messages;
+    auto it = m_conversations.constFind(conversationKey(a, b));
+    if (it == m_conversations.constEnd() || limit <= 0) {
+        return messages;
+    }
+
+    const QVector<qint64>& offsets = it->offsets;
+    const int stop = (end < 0 || end > offsets.size()) ? offsets.size() : end;
+    const int start = qMax(0, stop - limit);
+    messages.reserve(stop - start);
+    for (int i = start; i < stop; ++i) {
+        StoredMessage message;
+        if (readAt(offsets.at(i), &message)) {
+            messages.append(message);
+        }
+    }
+    return messages;
+}
+
+QVector<ConversationSummary> MessageStore::conversations(const QString& user, int limit)
+{
+    QVector<ConversationSummary> summaries;
+    auto inbox = m_inboxes.constFind(user);
+    if (inbox == m_inboxes.constEnd()) {
+        return summaries;
+    }
+
+    for (const QString& key : inbox->recent) {
+        if (summaries.size() >= limit) {
+            break;
+        }
+        const Conversation& conversation = m_conversations[key];
+        ConversationSummary summary;
+        summary.partner = (conversation.first == user) ? conversation.second : conversation.first;
+        summary.messageCount = conversation.offsets.size();
+        if (readAt(conversation.offsets.last(), &summary.last)) {
+            summaries.append(summary);
+        }
+    }
+    return summaries;
+}
+
+QString MessageStore::conversationKey(const QString& a, const QString& b)
+{
+    // Unordered pair: both directions share one conversation
+    const QChar separator(0x1f);
+    return a < b ? a + separator + b : b + separator + a;
+}
+
+bool MessageStore::readAt(qint64 offset, StoredMessage* message)
+{
+    uchar lengthBytes[FrameHeaderSize];
+    if (!m_file.seek(offset)
+        || m_file.read(reinterpret_cast<char*>(lengthBytes), FrameHeaderSize) != FrameHeaderSize) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    const quint32 length = qFromLittleEndian<quint32>(lengthBytes);
+    if (length > MaxFrameSize || !decode(m_file.read(length), message)) {
+        m_error = "messages.dat has a corrupt frame";
+        return false;
+    }
+    return true;
+}
+
+void MessageStore::index(qint64 offset, const StoredMessage& message)
+{
+    const QString key = conversationKey(message.from, message.to);
+    Conversation& conversation = m_conversations[key];
+    if (conversation.offsets.isEmpty()) {
+        conversation.first = qMin(message.from, message.to);
+        conversation.second = qMax(message.from, message.to);
+    }
+    conversation.offsets.append(offset);
+
+    touch(message.from, key);
+    if (message.to != message.from) {
+        touch(message.to, key);
+    }
+
+    ++m_count;
+    if (message.sequence != 0) {
+        m_sequences.insert(message.sequence);
+        m_lastSequence = qMax(m_lastSequence, message.sequence);
+    }
+}
+
+void MessageStore::touch(const QString& user, const QString& key)
+{
+    // Move-to-front: O(1) whether or not the conversation is already listed
+    Inbox& inbox = m_inboxes[user];
+    auto it = inbox.position.constFind(key);
+    if (it != inbox.position.constEnd()) {
+        inbox.recent.splice(inbox.recent.begin(), inbox.recent, it.value());
+    } else {
+        inbox.recent.push_front(key);
+        inbox.position.insert(key, inbox.recent.begin());
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef MESSAGESTORE_H
+#define MESSAGESTORE_H
+
+#include <QFile>
+#include <QHash>
+#include <QScopedPointer>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <list>
+
+class QLockFile;
+
+// ============================================================================
+// MESSAGE STORE (messages.dat)
+//
+// File layout (little-endian):
+//   [MessageStoreHeader]
+//   frames: quint32 length, then a QDataStream body
+//           (sequence, sentAt, from, to, text)
+//
+// The file is append-only. open() makes one sequential pass to rebuild two
+// in-memory indexes, then never scans again:
+//   - per conversation (unordered user pair): the file offsets of its
+//     messages in send order, so the newest N are the last N offsets
+//   - per user: conversations ordered by last activity, a move-to-front
+//     list with a hash of list positions, so a new message relinks one
+//     node and the inbox is read straight off the front
+// Opening a conversation or listing inbox previews therefore reads only the
+// frames on the requested page, however many messages the file holds.
+//
+// Clients sharing a data directory share the file. Appends (and the torn
+// tail cut in open()) hold an inter-process lock file beside it, and
+// refresh() indexes the frames other processes appended since the last
+// scan.
+//
+// Not thread-safe: callers serialize access.
+// ============================================================================
+
+struct MessageStoreHeader {
+    char magic[8];
+    quint32 version;
+    quint32 reserved;
+};
+
+struct StoredMessage {
+    quint64 sequence;   // Write-ahead log sequence, 0 if never logged
+    qint64 sentAt;      // Seconds since epoch
+    QString from;
+    QString to;
+    QString text;
+};
+
+struct ConversationSummary {
+    QString partner;
+    StoredMessage last;
+    int messageCount;
+};
+
+class MessageStore
+{
+public:
+    MessageStore();
+    ~MessageStore();
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+
+    quint64 count() const { return m_count; }
+
+    // Highest log sequence already stored. It can be ahead of the log after
+    // a crash, so the log resumes numbering after it.
+    quint64 lastSequence() const { return m_lastSequence; }
+
+    // A message whose log sequence is already stored is skipped, so
+    // replaying the log never duplicates one
+    bool append(const StoredMessage& message);
+
+    // Indexes frames appended by other processes; a frame still being
+    // written is left for the next call
+    void refresh();
+
+    int conversationSize(const QString& a, const QString& b) const;
+
+    // Up to limit messages of the a/b conversation ending just before
+    // message number end (-1 = newest), oldest first
+    QVector<StoredMessage> conversation(const QString& a, const QString& b,
+                                        int limit, int end = -1);
+
+    // The user's conversations, most recently active first
+    QVector<ConversationSummary> conversations(const QString& user, int limit);
+
+private:
+    Q_DISABLE_COPY(MessageStore)
+
+    struct Conversation {
+        QString first;
+        QString second;
+        QVector<qint64> offsets;
+    };
+
+    struct Inbox {
+        std::list<QString> recent;                                // Conversation keys
+        QHash<QString, std::list<QString>::iterator> position;
+    };
+
+    static QString conversationKey(const QString& a, const QString& b);
+
+    qint64 scan(qint64 offset);
+    bool readAt(qint64 offset, StoredMessage* message);
+    void index(qint64 offset, const StoredMessage& message);
+    void touch(const QString& user, const QString& key);
+
+    QFile m_file;
+    QScopedPointer<QLockFile> m_lock;   // Held while appending
+    qint64 m_end = 0;                   // Frames before this offset are indexed
+    quint64 m_count = 0;
+    quint64 m_lastSequence = 0;
+    QSet<quint64> m_sequences;   // Log sequences of the stored messages
+    QHash<QString, Conversation> m_conversations;
+    QHash<QString, Inbox> m_inboxes;
+    QString m_error;
+};
+
+#endif // MESSAGESTORE_H
@@ -0,0 +1,71 @@
+#include "messagetable.h"
+
+namespace {
+
+template <typename T>
+qint64 columnBytes(const QVector<T>& column)
+{
+    return qint64(column.capacity()) * qint64(sizeof(T));
+}
+
+} // namespace
+
+void MessageTable::clear()
+{
+    m_senders.clear();
+    m_outgoing.clear();
+    m_indexes.clear();
+    m_content.clear();
+    m_sentAt.clear();
+    m_text.clear();
+}
+
+void MessageTable::append(const Message& message)
+{
+    m_senders.append(m_names.intern(message.sender));
+    m_outgoing.append(message.isOutgoing);
+    m_indexes.append(message.index);
+    m_content.append(m_text.add(message.content));
+    m_sentAt.append(message.sentAt);
+}
+
+void MessageTable::prepend(const QVector<Message>& messages)
+{
+    const int count = messages.size();
+    if (count == 0) {
+        return;
+    }
+
+    // Open a gap at the front of each column, then fill it in order
+    m_senders.insert(m_senders.begin(), count, 0u);
+    m_outgoing.insert(m_outgoing.begin(), count, false);
+    m_indexes.insert(m_indexes.begin(), count, -1);
+    m_content.insert(m_content.begin(), count, StringArena::Ref());
+    m_sentAt.insert(m_sentAt.begin(), count, qint64(0));
+
+    for (int i = 0; i < count; ++i) {
+        const Message& message = messages.at(i);
+        m_senders[i] = m_names.intern(message.sender);
+        m_outgoing[i] = message.isOutgoing;
+        m_indexes[i] = message.index;
+        m_content[i] = m_text.add(message.content);
+        m_sentAt[i] = message.sentAt;
+    }
+}
+
+Message MessageTable::message(int row) const
+{
+    Message message;
+    message.sender = sender(row);
+    message.content = content(row);
+    message.sentAt = sentAt(row);
+    message.isOutgoing = isOutgoing(row);
+    message.index = index(row);
+    return message;
+}
+
+qint64 MessageTable::memoryUsage() const
+{
+    return columnBytes(m_senders) + columnBytes(m_outgoing) + columnBytes(m_indexes) + columnBytes(m_content)
+         + columnBytes(m_sentAt) + m_names.memoryUsage() + m_text.memoryUsage();
+}
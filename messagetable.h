@@ -0,0 +1,58 @@
+#ifndef MESSAGETABLE_H
+#define MESSAGETABLE_H
+
+#include "datatypes.h"
+#include "stringarena.h"
+#include <QVector>
+
+// ============================================================================
+// MESSAGE TABLE
+// The open conversation's messages, oldest first, one array per column:
+// senders interned in a NameTable, content in a StringArena.
+// Older pages are prepended as the user scrolls up; only the small columns
+// move, the text stays where it was appended.
+//
+// clear() keeps the capacity and the interned senders for the next
+// conversation load, like PostTable.
+// ============================================================================
+
+class MessageTable
+{
+public:
+    int size() const { return m_indexes.size(); }
+    bool isEmpty() const { return m_indexes.isEmpty(); }
+
+    void clear();
+    void append(const Message& message);
+    void prepend(const QVector<Message>& messages);
+
+    // Numeric columns
+    quint32 senderId(int row) const { return m_senders.at(row); }
+    bool isOutgoing(int row) const { return m_outgoing.at(row); }
+    int index(int row) const { return m_indexes.at(row); }
+    qint64 sentAt(int row) const { return m_sentAt.at(row); }
+
+    // Rows shown before they were stored get their position later
+    void setIndex(int row, int index) { m_indexes[row] = index; }
+
+    // Text columns
+    const QString& sender(int row) const { return m_names.name(m_senders.at(row)); }
+    QString content(int row) const { return m_text.text(m_content.at(row)); }
+
+    Message message(int row) const;
+
+    // Bytes held by the columns, the arena and the name table
+    qint64 memoryUsage() const;
+
+private:
+    QVector<quint32> m_senders;
+    QVector<bool> m_outgoing;
+    QVector<qint32> m_indexes;
+    QVector<qint64> m_sentAt;
+    QVector<StringArena::Ref> m_content;
+
+    NameTable m_names;
+    StringArena m_text;
+};
+
+#endif // MESSAGETABLE_H
@@ -0,0 +1,153 @@
+#include "notificationqueue.h"
+#include <QMutexLocker>
+
+NotificationQueue::NotificationQueue(const Options& options)
+    : m_options(options)
+{
+}
+
+quint64 NotificationQueue::coalescingKey(const Event& event)
+{
+    // Kind in the top byte, then what the rows coalesce on
+    quint64 subject = 0;
+    switch (event.kind) {
+    case Like:
+        subject = event.target;
+        break;
+    case Message:
+    case NewPost:
+        subject = event.actor;
+        break;
+    case Follow:
+    case CloseFriend:
+        break;
+    }
+    return (quint64(event.kind) << 56) | (subject & ((quint64(1) << 56) - 1));
+}
+
+bool NotificationQueue::post(const Event& event)
+{
+    QMutexLocker locker(&m_mutex);
+    Lane& lane = m_inboxes[event.recipient].lanes[event.priority ? 1 : 0];
+    const quint64 key = coalescingKey(event);
+
+    auto existing = lane.byKey.find(key);
+    if (existing != lane.byKey.end() && !existing.value()->row.unread) {
+        // Already seen: the new event starts a fresh row
+        lane.entries.erase(existing.value());
+        lane.byKey.erase(existing);
+        existing = lane.byKey.end();
+    }
+
+    if (existing != lane.byKey.end()) {
+        // Coalesce and move to the front
+        auto it = existing.value();
+        it->actors.insert(event.actor);
+        it->row.latestActor = event.actorName;
+        it->row.actorCount = it->actors.size();
+        it->row.eventCount++;
+        it->row.updatedAt = event.at;
+        lane.entries.splice(lane.entries.begin(), lane.entries, it);
+        return false;
+    }
+
+    Entry entry{ key, { event.kind, event.actorName, 1, 1, event.at, event.priority, true }, { event.actor } };
+    lane.entries.push_front(entry);
+    lane.byKey.insert(key, lane.entries.begin());
+    lane.unread++;
+
+    while (int(lane.entries.size()) > m_options.laneCapacity) {
+        const Entry& oldest = lane.entries.back();
+        if (oldest.row.unread) {
+            lane.unread--;
+        }
+        lane.byKey.remove(oldest.key);
+        lane.entries.pop_back();
+    }
+    return true;
+}
+
+int NotificationQueue::unreadCount(quint32 user) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_inboxes.constFind(user);
+    return it == m_inboxes.constEnd() ? 0 : it->lanes[0].unread + it->lanes[1].unread;
+}
+
+int NotificationQueue::priorityUnreadCount(quint32 user) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_inboxes.constFind(user);
+    return it == m_inboxes.constEnd() ? 0 : it->lanes[1].unread;
+}
+
+QVector<NotificationQueue::Row> NotificationQueue::rows(quint32 user, bool priority, int limit) const
+{
+    QVector<Row> result;
+    QMutexLocker locker(&m_mutex);
+    auto it = m_inboxes.constFind(user);
+    if (it == m_inboxes.constEnd()) {
+        return result;
+    }
+    const Lane& lane = it->lanes[priority ? 1 : 0];
+    result.reserve(qMin(limit, int(lane.entries.size())));
+    for (const Entry& entry : lane.entries) {
+        if (result.size() >= limit) {
+            break;
+        }
+        result.append(entry.row);
+    }
+    return result;
+}
+
+bool NotificationQueue::markAllRead(quint32 user)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_inboxes.find(user);
+    if (it == m_inboxes.end()) {
+        return false;
+    }
+
+    bool changed = false;
+    for (Lane& lane : it->lanes) {
+        if (lane.unread == 0) {
+            continue;
+        }
+        // Unread rows are the ones touched since the last read, so they
+        // cluster at the front
+        for (Entry& entry : lane.entries) {
+            if (lane.unread == 0) {
+                break;
+            }
+            if (entry.row.unread) {
+                entry.row.unread = false;
+                lane.unread--;
+            }
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+QString NotificationQueue::describe(const Row& row)
+{
+    const QString others = row.actorCount > 2
+        ? QString("%1 and %2 others").arg(row.latestActor).arg(row.actorCount - 1)
+        : row.actorCount == 2 ? QString("%1 and 1 other").arg(row.latestActor)
+                              : row.latestActor;
+    switch (row.kind) {
+    case Like:
+        return QString("%1 liked your post").arg(others);
+    case Follow:
+        return QString("%1 started following you").arg(others);
+    case CloseFriend:
+        return QString("%1 added you to their close friends ⭐").arg(others);
+    case Message:
+        return row.eventCount == 1 ? QString("%1 sent you a message").arg(row.latestActor)
+                                   : QString("%1 sent you %2 messages").arg(row.latestActor).arg(row.eventCount);
+    case NewPost:
+        return row.eventCount == 1 ? QString("%1 shared a new post").arg(row.latestActor)
+                                   : QString("%1 shared %2 new posts").arg(row.latestActor).arg(row.eventCount);
+    }
+    return QString();
+}
@@ -0,0 +1,105 @@
+#ifndef NOTIFICATIONQUEUE_H
+#define NOTIFICATIONQUEUE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <list>
+
+// ============================================================================
+// NOTIFICATION QUEUE
+// Per-user inbox with two lanes: priority (events from the recipient's
+// close friends) and regular. Each lane is a move-to-front list of rows,
+// newest first, with a hash from coalescing key to row:
+//   like          one row per post     "alice and 12 others liked your post"
+//   follow        one row              "alice and 3 others started following you"
+//   close friend  one row              "alice added you to their close friends"
+//   message       one row per sender   "alice sent you 4 messages"
+//   new post      one row per author   "alice shared 2 new posts"
+// so a viral post is one row, not thousands. An event for a row that has
+// been read starts a fresh row. Lanes are bounded; the oldest rows drop off.
+//
+// Unread counts are kept per lane as rows change state, so badges are O(1).
+// Thread-safe.
+// ============================================================================
+
+class NotificationQueue
+{
+public:
+    enum Kind : quint8 {
+        Like = 1,
+        Follow = 2,
+        CloseFriend = 3,
+        Message = 4,
+        NewPost = 5
+    };
+
+    struct Event {
+        Kind kind;
+        quint32 recipient;
+        quint32 actor;
+        QString actorName;
+        quint64 target;      // Post id for likes; otherwise unused
+        bool priority;
+        qint64 at;           // Seconds since epoch
+    };
+
+    struct Row {
+        Kind kind;
+        QString latestActor;
+        int actorCount;      // Distinct actors
+        int eventCount;
+        qint64 updatedAt;
+        bool priority;
+        bool unread;
+    };
+
+    struct Options {
+        int laneCapacity = 200;   // Rows kept per lane
+    };
+
+    explicit NotificationQueue(const Options& options = Options());
+
+    // Returns true when the recipient's unread count changed
+    bool post(const Event& event);
+
+    int unreadCount(quint32 user) const;
+    int priorityUnreadCount(quint32 user) const;
+
+    // Newest first
+    QVector<Row> rows(quint32 user, bool priority, int limit) const;
+
+    // Returns false if nothing was unread
+    bool markAllRead(quint32 user);
+
+    static QString describe(const Row& row);
+
+private:
+    Q_DISABLE_COPY(NotificationQueue)
+
+    struct Entry {
+        quint64 key;
+        Row row;
+        QSet<quint32> actors;
+    };
+
+    struct Lane {
+        std::list<Entry> entries;   // Newest first
+        QHash<quint64, std::list<Entry>::iterator> byKey;
+        int unread = 0;
+    };
+
+    struct Inbox {
+        Lane lanes[2];   // Regular, priority
+    };
+
+    static quint64 coalescingKey(const Event& event);
+
+    Options m_options;
+    mutable QMutex m_mutex;
+    QHash<quint32, Inbox> m_inboxes;
+};
+
+#endif // NOTIFICATIONQUEUE_H
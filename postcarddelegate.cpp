@@ -0,0 +1,283 @@
+#include "postcarddelegate.h"
+#include "feedmodel.h"
+#include "appstyle.h"
+#include "shadowcache.h"
+#include "imagecache.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <QTextLayout>
+#include <QPixmap>
+#include <QPixmapCache>
+
+namespace {
+
+const int CardPadding = 15;
+const int SectionSpacing = 12;
+const int AvatarSize = 40;
+const int ButtonHeight = 34;
+const int ButtonPadding = 15;
+const int ButtonSpacing = 6;
+const int MinPixmapCacheKb = 32 * 1024;   // Room for a few screens of card bodies
+
+QString likeText(int likes) { return QString("❤️ %1").arg(likes); }
+QString commentText(int comments) { return QString("💬 %1").arg(comments); }
+QString shareText() { return QStringLiteral("📤 Share"); }
+
+// Word-wraps text into rect, eliding the last visible line
+void drawWrappedText(QPainter* painter, const QRect& rect, const QString& text,
+                     const QFont& font, int maxLines)
+{
+    QFontMetrics fm(font);
+    QTextLayout layout(text, font);
+    layout.beginLayout();
+
+    int y = rect.top();
+    int lines = 0;
+    while (lines < maxLines) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) {
+            break;
+        }
+        line.setLineWidth(rect.width());
+        ++lines;
+
+        const bool lastAllowed = (lines == maxLines);
+        const int end = line.textStart() + line.textLength();
+        if (lastAllowed && end < text.size()) {
+            const QString rest = text.mid(line.textStart()).simplified();
+            painter->drawText(QPoint(rect.left(), y + fm.ascent()),
+                              fm.elidedText(rest, Qt::ElideRight, rect.width()));
+        } else {
+            painter->drawText(QPoint(rect.left(), y + fm.ascent()),
+                              text.mid(line.textStart(), line.textLength()).trimmed());
+        }
+        y += fm.lineSpacing();
+    }
+    layout.endLayout();
+}
+
+void drawOutlinedButton(QPainter* painter, const QRect& rect, const QString& text)
+{
+    painter->setPen(AppStyle::paintPalette().outlineButtonPen);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), 8, 8);
+    painter->drawText(rect, Qt::AlignCenter, text);
+}
+
+} // namespace
+
+PostCardDelegate::PostCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+    if (QPixmapCache::cacheLimit() < MinPixmapCacheKb) {
+        QPixmapCache::setCacheLimit(MinPixmapCacheKb);
+    }
+}
+
+PostCardDelegate::CardGeometry PostCardDelegate::cardGeometry(const QStyleOptionViewItem &option,
+                                                              const QModelIndex &index) const
+{
+    CardGeometry g;
+    g.card = option.rect.marginsRemoved(ShadowCache::margins(AppStyle::CardShadow));
+
+    const QRect inner = g.card.adjusted(CardPadding, CardPadding, -CardPadding, -CardPadding);
+
+    g.avatar = QRect(inner.left(), inner.top(), AvatarSize, AvatarSize);
+    g.header = QRect(g.avatar.right() + 10, inner.top(),
+                     inner.right() - g.avatar.right() - 10, AvatarSize);
+
+    const int actionsTop = inner.bottom() - ButtonHeight + 1;
+    const int bubbleTop = g.avatar.bottom() + 1 + SectionSpacing;
+    g.bubble = QRect(inner.left(), bubbleTop, inner.width(),
+                     actionsTop - SectionSpacing - bubbleTop);
+    g.content = g.bubble.adjusted(CardPadding, CardPadding, -CardPadding, -CardPadding);
+
+    // Media thumbnail: a square at the right of the bubble
+    if (index.data(FeedModel::HasMediaRole).toBool()) {
+        const int side = g.content.height();
+        g.media = QRect(g.content.right() - side + 1, g.content.top(), side, side);
+        g.content.setRight(g.media.left() - CardPadding - 1);
+    }
+
+    const QFontMetrics fm(AppStyle::paintPalette().buttonFont);
+    const int likes = index.data(FeedModel::LikesRole).toInt();
+    const int comments = index.data(FeedModel::CommentsRole).toInt();
+
+    int x = inner.left();
+    auto buttonRect = [&](const QString& text) {
+        const QRect r(x, actionsTop, fm.horizontalAdvance(text) + 2 * ButtonPadding, ButtonHeight);
+        x = r.right() + 1 + ButtonSpacing;
+        return r;
+    };
+    g.likeButton = buttonRect(likeText(likes));
+    g.commentButton = buttonRect(commentText(comments));
+    g.shareButton = buttonRect(shareText());
+
+    return g;
+}
+
+void PostCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                             const QModelIndex &index) const
+{
+    const CardGeometry g = cardGeometry(option, index);
+
+    // Images, or null while they are being decoded
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    QPixmap avatar;
+    QPixmap media;
+    if (m_images) {
+        avatar = m_images->pixmap(ImageCache::avatarPath(index.data(FeedModel::UsernameRole).toString()),
+                                  g.avatar.size(), ImageCache::Circle, dpr);
+        if (!g.media.isEmpty()) {
+            media = m_images->pixmap(index.data(FeedModel::MediaRole).toString(), g.media.size(),
+                                     ImageCache::Fill, dpr);
+        }
+    }
+
+    // Static part of the card, cached per post, size, visible timestamp (it
+    // changes at most once a minute, for all cards together) and which
+    // images were ready
+    const QString key = QString("postcard:%1:%2x%3@%4:%5:%6%7")
+        .arg(index.data(FeedModel::PostIdRole).toULongLong())
+        .arg(option.rect.width()).arg(option.rect.height()).arg(dpr)
+        .arg(index.data(FeedModel::TimestampRole).toString())
+        .arg(avatar.isNull() ? 0 : 1).arg(media.isNull() ? 0 : 1);
+
+    QPixmap body;
+    if (!QPixmapCache::find(key, &body)) {
+        body = QPixmap(option.rect.size() * dpr);
+        body.setDevicePixelRatio(dpr);
+        body.fill(Qt::transparent);
+
+        QStyleOptionViewItem local(option);
+        local.rect = QRect(QPoint(0, 0), option.rect.size());
+        QPainter bodyPainter(&body);
+        paintCardBody(&bodyPainter, local, index, cardGeometry(local, index), avatar, media);
+        bodyPainter.end();
+
+        QPixmapCache::insert(key, body);
+    }
+    painter->drawPixmap(option.rect.topLeft(), body);
+
+    // Live counters
+    paintActions(painter, option, index, g);
+}
+
+void PostCardDelegate::paintCardBody(QPainter *painter, const QStyleOptionViewItem &option,
+                                     const QModelIndex &index, const CardGeometry &g,
+                                     const QPixmap &avatar, const QPixmap &media) const
+{
+    Q_UNUSED(option);
+    const AppStyle::PaintPalette& palette = AppStyle::paintPalette();
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    // Shadow and card background
+    ShadowCache::paint(painter, g.card, AppStyle::CardShadow);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(palette.cardBackground);
+    painter->drawRoundedRect(g.card, 15, 15);
+
+    // Avatar (emoji placeholder until the image is decoded)
+    if (!avatar.isNull()) {
+        painter->drawPixmap(g.avatar, avatar);
+        painter->setPen(palette.textPen);
+    } else {
+        painter->setBrush(palette.avatarBackground);
+        painter->drawEllipse(g.avatar);
+        painter->setPen(palette.textPen);
+        painter->setFont(palette.avatarFont);
+        painter->drawText(g.avatar, Qt::AlignCenter, QStringLiteral("😊"));
+    }
+
+    // Header (username + priority star + timestamp)
+    const QString username = index.data(FeedModel::UsernameRole).toString();
+    painter->setFont(palette.usernameFont);
+    painter->drawText(g.header, Qt::AlignLeft | Qt::AlignVCenter, username);
+
+    if (index.data(FeedModel::PriorityRole).toBool()) {
+        QRect starRect = g.header;
+        starRect.setLeft(g.header.left() + QFontMetrics(palette.usernameFont).horizontalAdvance(username) + 8);
+        painter->setFont(palette.avatarFont);
+        painter->drawText(starRect, Qt::AlignLeft | Qt::AlignVCenter, QStringLiteral("⭐"));
+    }
+
+    painter->setPen(palette.mutedTextPen);
+    painter->setFont(palette.timestampFont);
+    painter->drawText(g.header, Qt::AlignRight | Qt::AlignVCenter,
+                      index.data(FeedModel::TimestampRole).toString());
+
+    // Content area (purple bubble)
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(palette.contentGradient);
+    painter->drawRoundedRect(g.bubble, 12, 12);
+
+    if (!g.media.isEmpty()) {
+        if (!media.isNull()) {
+            QPainterPath clip;
+            clip.addRoundedRect(g.media, 8, 8);
+            painter->save();
+            painter->setClipPath(clip);
+            painter->drawPixmap(g.media, media);
+            painter->restore();
+        } else {
+            painter->setBrush(palette.mediaPlaceholder);
+            painter->drawRoundedRect(g.media, 8, 8);
+        }
+    }
+
+    painter->setPen(palette.textPen);
+    drawWrappedText(painter, g.content, index.data(FeedModel::ContentRole).toString(),
+                    palette.contentFont, MaxContentLines);
+
+    painter->restore();
+}
+
+void PostCardDelegate::paintActions(QPainter *painter, const QStyleOptionViewItem &option,
+                                    const QModelIndex &index, const CardGeometry &g) const
+{
+    Q_UNUSED(option);
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setFont(AppStyle::paintPalette().buttonFont);
+    drawOutlinedButton(painter, g.likeButton, likeText(index.data(FeedModel::LikesRole).toInt()));
+    drawOutlinedButton(painter, g.commentButton, commentText(index.data(FeedModel::CommentsRole).toInt()));
+    drawOutlinedButton(painter, g.shareButton, shareText());
+    painter->restore();
+}
+
+QSize PostCardDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    return QSize(qMax(option.rect.width(), 300), CardHeight);
+}
+
+bool PostCardDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                   const QStyleOptionViewItem &option,
+                                   const QModelIndex &index)
+{
+    if (event->type() == QEvent::MouseButtonRelease) {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() == Qt::LeftButton) {
+            const CardGeometry g = cardGeometry(option, index);
+            const QPoint pos = mouseEvent->pos();
+            if (g.likeButton.contains(pos)) {
+                emit likeClicked(index.row());
+                return true;
+            }
+            if (g.commentButton.contains(pos)) {
+                emit commentClicked(index.row());
+                return true;
+            }
+            if (g.shareButton.contains(pos)) {
+                emit shareClicked(index.row());
+                return true;
+            }
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
@@ -0,0 +1,77 @@
+#ifndef POSTCARDDELEGATE_H
+#define POSTCARDDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPixmap>
+#include <QRect>
+
+class ImageCache;
+
+// ============================================================================
+// POST CARD DELEGATE
+// Paints a feed card (header, purple content bubble, action buttons) straight
+// onto the view's viewport. Cards have a fixed height so the view can use
+// uniform item sizes and lay out 100k rows as cheaply as 10.
+//
+// Everything except the action buttons, drop shadow included, is rendered
+// once per post into a cached pixmap. A like or comment only changes a
+// counter role, so the repaint is one blit plus the button row.
+//
+// Avatars and post media come from the ImageCache. Until they are decoded
+// the card shows placeholders; the body is cached per image state, so the
+// repaint after imageReady() renders it once more with the images in.
+// ============================================================================
+
+class PostCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CardHeight = 260;   // Card plus room for its shadow
+    static constexpr int MaxContentLines = 4;
+
+    explicit PostCardDelegate(QObject *parent = nullptr);
+
+    // Source of avatars and media; without one only placeholders are painted
+    void setImageCache(ImageCache* images) { m_images = images; }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const override;
+
+signals:
+    void likeClicked(int row);
+    void commentClicked(int row);
+    void shareClicked(int row);
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option,
+                     const QModelIndex &index) override;
+
+private:
+    struct CardGeometry {
+        QRect card;
+        QRect avatar;
+        QRect header;
+        QRect bubble;
+        QRect content;
+        QRect media;         // Empty when the post has none
+        QRect likeButton;
+        QRect commentButton;
+        QRect shareButton;
+    };
+
+    CardGeometry cardGeometry(const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const;
+    void paintCardBody(QPainter *painter, const QStyleOptionViewItem &option,
+                       const QModelIndex &index, const CardGeometry &g,
+                       const QPixmap &avatar, const QPixmap &media) const;
+    void paintActions(QPainter *painter, const QStyleOptionViewItem &option,
+                      const QModelIndex &index, const CardGeometry &g) const;
+
+    ImageCache* m_images = nullptr;
+};
+
+#endif // POSTCARDDELEGATE_H
@@ -0,0 +1,218 @@
+#include "poststore.h"
+#include <QSaveFile>
+#include <QHash>
+#include <QByteArray>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char PostStoreMagic[8] = { 'P', 'S', 'P', 'O', 'S', 'T', 'S', '1' };
+const quint32 PostStoreVersion = 1;
+
+static_assert(sizeof(PostStoreHeader) == 64, "posts.dat header layout changed");
+static_assert(sizeof(PostRecord) == 56, "posts.dat record layout changed");
+static_assert(sizeof(PostIndexEntry) == 16, "posts.dat index layout changed");
+
+quint64 align8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+} // namespace
+
+PostStore::PostStore()
+{
+}
+
+PostStore::~PostStore()
+{
+    close();
+}
+
+bool PostStore::open(const QString& path)
+{
+    close();
+
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    m_error = "posts.dat is little-endian; big-endian hosts are not supported";
+    return false;
+#endif
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    const quint64 fileSize = quint64(m_file.size());
+    if (fileSize < sizeof(PostStoreHeader)) {
+        m_error = "posts.dat is truncated";
+        close();
+        return false;
+    }
+
+    m_map = m_file.map(0, m_file.size());
+    if (!m_map) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    // Only the header and section bounds are checked here, so opening stays
+    // O(1) regardless of how many posts the file holds. Each section is
+    // checked as offset, then size against what is left, so a corrupt
+    // offset cannot wrap the sum back into range.
+    const PostStoreHeader* header = reinterpret_cast<const PostStoreHeader*>(m_map);
+    const quint64 count = header->recordCount;
+    const bool valid =
+        std::memcmp(header->magic, PostStoreMagic, sizeof(PostStoreMagic)) == 0
+        && header->version == PostStoreVersion
+        && header->recordSize == sizeof(PostRecord)
+        && count <= fileSize / sizeof(PostRecord)
+        && header->recordsOffset % 8 == 0
+        && header->indexOffset % 8 == 0
+        && header->recordsOffset <= fileSize
+        && count * sizeof(PostRecord) <= fileSize - header->recordsOffset
+        && header->indexOffset <= fileSize
+        && count * sizeof(PostIndexEntry) <= fileSize - header->indexOffset
+        && header->heapOffset <= fileSize
+        && header->heapSize <= fileSize - header->heapOffset;
+
+    if (!valid) {
+        m_error = "posts.dat has an invalid header";
+        close();
+        return false;
+    }
+
+    m_count = count;
+    m_records = reinterpret_cast<const PostRecord*>(m_map + header->recordsOffset);
+    m_index = reinterpret_cast<const PostIndexEntry*>(m_map + header->indexOffset);
+    m_heap = m_map + header->heapOffset;
+    m_heapSize = header->heapSize;
+    m_error.clear();
+    return true;
+}
+
+void PostStore::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_count = 0;
+    m_records = nullptr;
+    m_index = nullptr;
+    m_heap = nullptr;
+    m_heapSize = 0;
+}
+
+QString PostStore::string(const PostStoreString& ref) const
+{
+    const quint64 bytes = quint64(ref.length) * sizeof(QChar);
+    if (ref.length == 0 || ref.offset % 2 != 0
+        || ref.offset > m_heapSize || bytes > m_heapSize - ref.offset) {
+        return QString();
+    }
+    return QString::fromRawData(reinterpret_cast<const QChar*>(m_heap + ref.offset),
+                                int(ref.length));
+}
+
+qint64 PostStore::findById(quint64 postId) const
+{
+    const PostIndexEntry* end = m_index + m_count;
+    const PostIndexEntry* it = std::lower_bound(m_index, end, postId,
+        [](const PostIndexEntry& entry, quint64 id) { return entry.postId < id; });
+    if (it == end || it->postId != postId || it->record >= m_count) {
+        return -1;
+    }
+    return qint64(it->record);
+}
+
+bool PostStore::write(const QString& path, const QVector<StoredPost>& posts, QString* error)
+{
+    // Build the string heap, sharing repeated strings (usernames, media paths)
+    QByteArray heap;
+    QHash<QString, PostStoreString> interned;
+    auto intern = [&](const QString& text) {
+        if (text.isEmpty()) {
+            return PostStoreString{ 0, 0 };
+        }
+        auto it = interned.constFind(text);
+        if (it != interned.constEnd()) {
+            return it.value();
+        }
+        PostStoreString ref{ quint32(heap.size()), quint32(text.size()) };
+        for (QChar ch : text) {
+            const quint16 unit = qToLittleEndian(ch.unicode());
+            heap.append(reinterpret_cast<const char*>(&unit), sizeof(unit));
+        }
+        interned.insert(text, ref);
+        return ref;
+    };
+
+    QVector<PostRecord> records;
+    QVector<PostIndexEntry> index;
+    records.reserve(posts.size());
+    index.reserve(posts.size());
+
+    for (const StoredPost& post : posts) {
+        PostRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.postId = post.postId;
+        record.createdAt = post.createdAt;
+        record.authorId = post.authorId;
+        record.flags = post.flags;
+        record.likes = post.likes;
+        record.comments = post.comments;
+        record.username = intern(post.username);
+        record.content = intern(post.content);
+        record.media = intern(post.media);
+        index.append({ post.postId, quint64(records.size()) });
+        records.append(record);
+    }
+
+    std::sort(index.begin(), index.end(), [](const PostIndexEntry& a, const PostIndexEntry& b) {
+        return a.postId < b.postId;
+    });
+
+    PostStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PostStoreMagic, sizeof(PostStoreMagic));
+    header.version = PostStoreVersion;
+    header.recordSize = sizeof(PostRecord);
+    header.recordCount = quint64(records.size());
+    header.recordsOffset = sizeof(PostStoreHeader);
+    header.indexOffset = align8(header.recordsOffset + header.recordCount * sizeof(PostRecord));
+    header.heapOffset = align8(header.indexOffset + header.recordCount * sizeof(PostIndexEntry));
+    header.heapSize = quint64(heap.size());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    auto writeAt = [&file](quint64 offset, const char* data, qint64 size) {
+        const QByteArray padding(int(offset - quint64(file.pos())), '\0');
+        return file.write(padding) == padding.size() && file.write(data, size) == size;
+    };
+
+    const bool ok =
+        writeAt(0, reinterpret_cast<const char*>(&header), sizeof(header))
+        && writeAt(header.recordsOffset, reinterpret_cast<const char*>(records.constData()),
+                   qint64(records.size()) * qint64(sizeof(PostRecord)))
+        && writeAt(header.indexOffset, reinterpret_cast<const char*>(index.constData()),
+                   qint64(index.size()) * qint64(sizeof(PostIndexEntry)))
+        && writeAt(header.heapOffset, heap.constData(), heap.size());
+
+    if (!ok || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
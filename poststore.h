@@ -0,0 +1,112 @@
+#ifndef POSTSTORE_H
+#define POSTSTORE_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// ============================================================================
+// POST STORE (posts.dat)
+//
+// File layout (little-endian, every section 8-byte aligned):
+//   [PostStoreHeader]
+//   [PostRecord x recordCount]        fixed-width records, feed order
+//   [PostIndexEntry x recordCount]    offsets index sorted by postId
+//   [string heap]                     UTF-16 text referenced by records
+//
+// The file is memory-mapped read-only. Strings are handed out with
+// QString::fromRawData, so they point straight into the mapping: nothing is
+// copied and only the pages that are actually read get faulted in. Any
+// QString obtained from the store must not outlive it.
+// ============================================================================
+
+struct PostStoreString {
+    quint32 offset;   // Byte offset into the string heap
+    quint32 length;   // Length in UTF-16 code units
+};
+
+struct PostRecord {
+    enum Flags : quint32 {
+        FlagPriority = 0x1,           // Author marked as close friend
+        FlagCloseFriendsOnly = 0x2    // Visible to close friends only
+    };
+
+    quint64 postId;
+    qint64 createdAt;      // Seconds since epoch
+    quint32 authorId;
+    quint32 flags;
+    qint32 likes;
+    qint32 comments;
+    PostStoreString username;
+    PostStoreString content;
+    PostStoreString media;
+};
+
+struct PostIndexEntry {
+    quint64 postId;
+    quint64 record;
+};
+
+struct PostStoreHeader {
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+    quint64 recordCount;
+    quint64 recordsOffset;
+    quint64 indexOffset;
+    quint64 heapOffset;
+    quint64 heapSize;
+    quint64 reserved;
+};
+
+// Input for PostStore::write()
+struct StoredPost {
+    quint64 postId;
+    quint32 authorId;
+    qint64 createdAt;
+    int likes;
+    int comments;
+    quint32 flags;
+    QString username;
+    QString content;
+    QString media;
+};
+
+class PostStore
+{
+public:
+    PostStore();
+    ~PostStore();
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_records != nullptr; }
+    QString errorString() const { return m_error; }
+
+    quint64 count() const { return m_count; }
+    const PostRecord& record(quint64 i) const { return m_records[i]; }
+
+    // Zero-copy view of a string stored in the heap
+    QString string(const PostStoreString& ref) const;
+
+    // Record number for a post id, or -1 (binary search over the index)
+    qint64 findById(quint64 postId) const;
+
+    // Serializes posts (in feed order) into a new posts.dat
+    static bool write(const QString& path, const QVector<StoredPost>& posts,
+                      QString* error = nullptr);
+
+private:
+    Q_DISABLE_COPY(PostStore)
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    quint64 m_count = 0;
+    const PostRecord* m_records = nullptr;
+    const PostIndexEntry* m_index = nullptr;
+    const uchar* m_heap = nullptr;
+    quint64 m_heapSize = 0;
+    QString m_error;
+};
+
+#endif // POSTSTORE_H
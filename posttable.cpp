@@ -0,0 +1,98 @@
+#include "posttable.h"
+#include <algorithm>
+
+namespace {
+
+// Capacity for at least rows, doubling so that page-by-page appends stay
+// amortized O(1)
+int grownCapacity(int capacity, int rows)
+{
+    return rows <= capacity ? capacity : qMax(rows, 2 * capacity);
+}
+
+template <typename T>
+qint64 columnBytes(const QVector<T>& column)
+{
+    return qint64(column.capacity()) * qint64(sizeof(T));
+}
+
+} // namespace
+
+void PostTable::reserve(int rows)
+{
+    m_postIds.reserve(rows);
+    m_authors.reserve(rows);
+    m_likes.reserve(rows);
+    m_comments.reserve(rows);
+    m_priority.reserve(rows);
+    m_createdAt.reserve(rows);
+    m_content.reserve(rows);
+    m_media.reserve(rows);
+}
+
+void PostTable::clear()
+{
+    m_postIds.clear();
+    m_authors.clear();
+    m_likes.clear();
+    m_comments.clear();
+    m_priority.clear();
+    m_createdAt.clear();
+    m_content.clear();
+    m_media.clear();
+    m_text.clear();
+}
+
+void PostTable::append(const Post& post)
+{
+    m_postIds.append(post.postId);
+    m_authors.append(m_names.intern(post.username));
+    m_likes.append(post.likes);
+    m_comments.append(post.comments);
+    m_priority.append(post.isPriority);
+    m_createdAt.append(post.createdAt);
+    m_content.append(m_text.add(post.content));
+    m_media.append(m_text.add(post.media));
+}
+
+void PostTable::append(const QVector<Post>& posts)
+{
+    // At most one growth step for the columns and the arena per page
+    int chars = 0;
+    for (const Post& post : posts) {
+        chars += post.content.size() + post.media.size();
+    }
+    reserve(grownCapacity(m_postIds.capacity(), size() + posts.size()));
+    m_text.reserve(grownCapacity(m_text.capacity(), m_text.size() + chars));
+
+    for (const Post& post : posts) {
+        append(post);
+    }
+}
+
+int PostTable::indexOf(quint64 postId) const
+{
+    const auto it = std::find(m_postIds.cbegin(), m_postIds.cend(), postId);
+    return it == m_postIds.cend() ? -1 : int(it - m_postIds.cbegin());
+}
+
+Post PostTable::post(int row) const
+{
+    Post post;
+    post.username = username(row);
+    post.content = content(row);
+    post.createdAt = createdAt(row);
+    post.likes = likes(row);
+    post.comments = comments(row);
+    post.isPriority = isPriority(row);
+    post.media = media(row);
+    post.postId = postId(row);
+    return post;
+}
+
+qint64 PostTable::memoryUsage() const
+{
+    return columnBytes(m_postIds) + columnBytes(m_authors) + columnBytes(m_likes) + columnBytes(m_comments)
+         + columnBytes(m_priority) + columnBytes(m_createdAt) + columnBytes(m_content) + columnBytes(m_media)
+         + m_names.memoryUsage() + m_text.memoryUsage();
+}
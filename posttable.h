@@ -0,0 +1,75 @@
+#ifndef POSTTABLE_H
+#define POSTTABLE_H
+
+#include "datatypes.h"
+#include "stringarena.h"
+#include <QVector>
+
+// ============================================================================
+// POST TABLE
+// The client's feed rows, one array per column. Ranking, filtering and
+// like updates read only the small numeric columns (id, author, counters,
+// priority, creation time), which stay contiguous in cache; content and
+// media live in a StringArena and authors are interned in a NameTable. Text is
+// materialized per row, at paint time.
+//
+// clear() is a bulk reset for reloads: rows go, but the columns and the
+// arena keep their capacity and the author names stay interned, so the
+// next page fills storage that is already there.
+// ============================================================================
+
+class PostTable
+{
+public:
+    int size() const { return m_postIds.size(); }
+    bool isEmpty() const { return m_postIds.isEmpty(); }
+
+    void reserve(int rows);
+    void clear();
+    void append(const Post& post);
+    void append(const QVector<Post>& posts);
+
+    // Numeric columns
+    quint64 postId(int row) const { return m_postIds.at(row); }
+    quint32 authorId(int row) const { return m_authors.at(row); }
+    int likes(int row) const { return m_likes.at(row); }
+    int comments(int row) const { return m_comments.at(row); }
+    bool isPriority(int row) const { return m_priority.at(row); }
+    qint64 createdAt(int row) const { return m_createdAt.at(row); }
+    bool hasMedia(int row) const { return m_media.at(row).length > 0; }
+
+    void incrementLikes(int row) { ++m_likes[row]; }
+    void incrementComments(int row) { ++m_comments[row]; }
+
+    // Row of the post, or -1
+    int indexOf(quint64 postId) const;
+
+    // Text columns
+    const QString& username(int row) const { return m_names.name(m_authors.at(row)); }
+    QString content(int row) const { return m_text.text(m_content.at(row)); }
+    QString media(int row) const { return m_text.text(m_media.at(row)); }
+    QStringView contentView(int row) const { return m_text.view(m_content.at(row)); }
+
+    // Every column of one row, as the backend delivered it
+    Post post(int row) const;
+
+    const NameTable& authors() const { return m_names; }
+
+    // Bytes held by the columns, the arena and the name table
+    qint64 memoryUsage() const;
+
+private:
+    QVector<quint64> m_postIds;
+    QVector<quint32> m_authors;
+    QVector<qint32> m_likes;
+    QVector<qint32> m_comments;
+    QVector<bool> m_priority;
+    QVector<qint64> m_createdAt;
+    QVector<StringArena::Ref> m_content;
+    QVector<StringArena::Ref> m_media;
+
+    NameTable m_names;
+    StringArena m_text;
+};
+
+#endif // POSTTABLE_H
@@ -0,0 +1,104 @@
+#include "scratcharena.h"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <optional>
+
+namespace {
+
+const size_t InitialBlockBytes = 16 * 1024;
+const size_t MaxBlockBytes = 4 * 1024 * 1024;   // Larger requests keep spilling
+
+std::atomic<bool> g_enabled{ true };
+
+// Heap fallback that remembers how much it handed out
+class SpillResource : public std::pmr::memory_resource
+{
+public:
+    size_t spilled = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        spilled += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+struct ThreadArena {
+    std::unique_ptr<unsigned char[]> block;
+    size_t blockBytes = 0;
+    SpillResource spill;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+    std::pmr::memory_resource* active = nullptr;
+    int depth = 0;
+
+    void open()
+    {
+        if (!g_enabled.load(std::memory_order_relaxed)) {
+            active = std::pmr::new_delete_resource();
+            return;
+        }
+        if (!block) {
+            blockBytes = InitialBlockBytes;
+            block.reset(new unsigned char[blockBytes]);
+        }
+        spill.spilled = 0;
+        arena.emplace(block.get(), blockBytes, &spill);
+        active = &*arena;
+    }
+
+    void close()
+    {
+        // Everything allocated since open() goes at once, spills included
+        arena.reset();
+        active = nullptr;
+        if (spill.spilled > 0 && blockBytes < MaxBlockBytes) {
+            size_t grown = blockBytes;
+            while (grown < blockBytes + spill.spilled && grown < MaxBlockBytes) {
+                grown *= 2;
+            }
+            blockBytes = grown;
+            block.reset(new unsigned char[blockBytes]);
+        }
+    }
+};
+
+thread_local ThreadArena t_arena;
+
+} // namespace
+
+ScratchArena::Scope::Scope()
+{
+    if (t_arena.depth++ == 0) {
+        t_arena.open();
+    }
+    m_resource = t_arena.active;
+}
+
+ScratchArena::Scope::~Scope()
+{
+    if (--t_arena.depth == 0) {
+        t_arena.close();
+    }
+}
+
+void ScratchArena::setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ScratchArena::isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,46 @@
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <QtGlobal>
+#include <memory_resource>
+
+// ============================================================================
+// SCRATCH ARENA
+// Per-thread bump allocator for buffers that live for one request: ranking
+// heaps, author sets, merge buffers. While the outermost Scope on a thread
+// is open, allocations come from a block the thread keeps between requests
+// and are never freed one by one; closing that Scope resets the whole
+// arena at once.
+//
+// A request that outgrows the block spills to the heap, and the block is
+// regrown to that high-water mark afterwards, so in steady state a feed
+// page makes no heap allocations for its scratch buffers.
+//
+// Scopes nest (inner ones share the outer arena). Containers built on a
+// Scope's resource must not outlive it.
+// ============================================================================
+
+class ScratchArena
+{
+public:
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+
+        std::pmr::memory_resource* resource() const { return m_resource; }
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        std::pmr::memory_resource* m_resource;
+    };
+
+    // When off, Scope::resource() is the plain heap (for before/after
+    // measurements); takes effect at the next outermost Scope
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+};
+
+#endif // SCRATCHARENA_H
@@ -0,0 +1,299 @@
+#include "searchindex.h"
+#include <QTextBoundaryFinder>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+
+const quint32 BlockSize = 128;
+
+void writeVarint(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+quint32 readVarint(const uchar*& p)
+{
+    quint32 value = 0;
+    int shift = 0;
+    uchar byte;
+    do {
+        byte = *p++;
+        value |= quint32(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+} // namespace
+
+// ============================================================================
+// POSTING LISTS
+// ============================================================================
+
+void SearchIndex::PostingList::append(quint32 doc)
+{
+    // Ids only grow, so a repeated word in the same document is a no-op
+    if (count > 0 && doc <= last) {
+        return;
+    }
+    if (blocks.isEmpty() || blocks.last().count == BlockSize) {
+        blocks.append({ doc, quint32(data.size()), 1 });
+    } else {
+        writeVarint(data, doc - last);
+        blocks.last().count++;
+    }
+    last = doc;
+    count++;
+}
+
+// Walks one posting list from the newest id down, a block at a time
+class SearchIndex::Cursor
+{
+public:
+    explicit Cursor(const PostingList* list)
+        : m_list(list)
+        , m_block(list->blocks.size() - 1)
+    {
+        if (m_block >= 0) {
+            load();
+        }
+    }
+
+    bool valid() const { return m_block >= 0; }
+    quint32 doc() const { return m_docs[m_pos]; }
+
+    // Moves to the largest id <= target
+    void seek(quint32 target)
+    {
+        if (!valid() || doc() <= target) {
+            return;
+        }
+        if (m_docs[0] > target) {
+            // Earlier blocks whose first id is past the target are skipped
+            // without decoding them
+            int low = 0;
+            int high = m_block;
+            while (low < high) {
+                const int mid = (low + high) / 2;
+                if (m_list->blocks.at(mid).first <= target) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            m_block = low - 1;
+            if (m_block < 0) {
+                return;
+            }
+            load();
+        }
+        int low = 0;
+        int high = m_pos + 1;
+        while (low < high) {
+            const int mid = (low + high) / 2;
+            if (m_docs[mid] <= target) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        m_pos = low - 1;
+    }
+
+private:
+    void load()
+    {
+        const Block& block = m_list->blocks.at(m_block);
+        const uchar* p = reinterpret_cast<const uchar*>(m_list->data.constData()) + block.offset;
+        m_docs.resize(int(block.count));
+        m_docs[0] = block.first;
+        for (int i = 1; i < m_docs.size(); ++i) {
+            m_docs[i] = m_docs[i - 1] + readVarint(p);
+        }
+        m_pos = m_docs.size() - 1;
+    }
+
+    const PostingList* m_list;
+    int m_block;
+    int m_pos = -1;
+    QVarLengthArray<quint32, BlockSize> m_docs;
+};
+
+// Union of the cursors for one query word (several terms for a prefix)
+class SearchIndex::Group
+{
+public:
+    void add(const PostingList* list) { m_cursors.emplace_back(list); }
+
+    bool valid() const
+    {
+        return std::any_of(m_cursors.begin(), m_cursors.end(), [](const Cursor& c) { return c.valid(); });
+    }
+
+    quint32 doc() const
+    {
+        quint32 best = 0;
+        for (const Cursor& cursor : m_cursors) {
+            if (cursor.valid()) {
+                best = qMax(best, cursor.doc());
+            }
+        }
+        return best;
+    }
+
+    void seek(quint32 target)
+    {
+        for (Cursor& cursor : m_cursors) {
+            cursor.seek(target);
+        }
+    }
+
+private:
+    std::vector<Cursor> m_cursors;
+};
+
+// ============================================================================
+// INDEX
+// ============================================================================
+
+SearchIndex::SearchIndex(const Options& options)
+    : m_options(options)
+{
+}
+
+void SearchIndex::clear()
+{
+    m_terms.clear();
+    m_users.clear();
+    m_documentCount = 0;
+}
+
+quint32 SearchIndex::addDocument(const QString& username, const QString& content)
+{
+    const quint32 doc = m_documentCount++;
+    for (const QString& word : tokenize(content)) {
+        m_terms[word].append(doc);
+    }
+    for (const QString& word : tokenize(username)) {
+        m_terms[word].append(doc);
+    }
+    if (!username.isEmpty()) {
+        m_users.insert(username.toCaseFolded(), username);
+    }
+    return doc;
+}
+
+quint64 SearchIndex::postingBytes() const
+{
+    quint64 bytes = 0;
+    for (const PostingList& list : m_terms) {
+        bytes += quint64(list.data.size()) + quint64(list.blocks.size()) * sizeof(Block);
+    }
+    return bytes;
+}
+
+QVector<quint32> SearchIndex::search(const QString& query, int limit) const
+{
+    QVector<quint32> hits;
+    const QStringList words = tokenize(query);
+    if (words.isEmpty() || limit <= 0) {
+        return hits;
+    }
+    const bool lastIsPrefix = !query.at(query.size() - 1).isSpace();
+
+    std::vector<Group> groups;
+    groups.reserve(size_t(words.size()));
+    for (int i = 0; i < words.size(); ++i) {
+        const QString& word = words.at(i);
+        Group group;
+        if (i == words.size() - 1 && lastIsPrefix) {
+            QVector<const PostingList*> expansions;
+            for (auto it = m_terms.lowerBound(word); it != m_terms.constEnd() && it.key().startsWith(word); ++it) {
+                expansions.append(&it.value());
+            }
+            if (expansions.size() > m_options.prefixExpansions) {
+                auto byCount = [](const PostingList* a, const PostingList* b) { return a->count > b->count; };
+                std::partial_sort(expansions.begin(), expansions.begin() + m_options.prefixExpansions,
+                                  expansions.end(), byCount);
+                expansions.resize(m_options.prefixExpansions);
+            }
+            for (const PostingList* list : expansions) {
+                group.add(list);
+            }
+        } else {
+            auto it = m_terms.constFind(word);
+            if (it != m_terms.constEnd()) {
+                group.add(&it.value());
+            }
+        }
+        if (!group.valid()) {
+            return hits;   // A word with no postings matches nothing
+        }
+        groups.push_back(std::move(group));
+    }
+
+    // Leapfrog intersection from the newest id down: every group seeks to
+    // the current target, which drops to the smallest id any of them found
+    quint32 target = std::numeric_limits<quint32>::max();
+    while (hits.size() < limit) {
+        bool agreed = true;
+        for (Group& group : groups) {
+            group.seek(target);
+            if (!group.valid()) {
+                return hits;
+            }
+            if (group.doc() < target) {
+                target = group.doc();
+                agreed = false;
+            }
+        }
+        if (!agreed) {
+            continue;
+        }
+        hits.append(target);
+        if (target == 0) {
+            break;
+        }
+        --target;
+    }
+    return hits;
+}
+
+QStringList SearchIndex::searchUsers(const QString& prefix, int limit) const
+{
+    QStringList names;
+    const QString folded = prefix.trimmed().toCaseFolded();
+    if (folded.isEmpty()) {
+        return names;
+    }
+    for (auto it = m_users.lowerBound(folded);
+         it != m_users.constEnd() && it.key().startsWith(folded) && names.size() < limit; ++it) {
+        names.append(it.value());
+    }
+    return names;
+}
+
+QStringList SearchIndex::tokenize(const QString& text)
+{
+    QStringList words;
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Word, text);
+    int start = 0;
+    while (finder.toNextBoundary() != -1) {
+        const int end = finder.position();
+        if (finder.boundaryReasons() & QTextBoundaryFinder::EndOfItem) {
+            const QStringView word = QStringView(text).mid(start, end - start);
+            if (std::any_of(word.begin(), word.end(), [](QChar c) { return c.isLetterOrNumber(); })) {
+                words.append(word.toString().toCaseFolded());
+            }
+        }
+        start = end;
+    }
+    return words;
+}
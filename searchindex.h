@@ -0,0 +1,84 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// ============================================================================
+// SEARCH INDEX
+// In-memory inverted index over post content and author names.
+//
+// Text is split into words with QTextBoundaryFinder (Unicode word rules,
+// so "café", "naïve" and CJK text tokenize correctly) and case-folded.
+// Each term maps to a posting list of document ids in ascending order,
+// stored as varint deltas in blocks of 128 with the first id of every
+// block kept raw. Queries walk the lists newest (highest id) first and
+// skip whole blocks whose first id is past the target, so intersecting a
+// rare term with a common one never decodes most of the common list.
+//
+// The dictionary is sorted, so the last word of a query is matched as a
+// prefix (search-as-you-type): it expands to every term starting with it,
+// capped to the most frequent ones.
+//
+// Documents get ids in the order they are added; add them oldest first
+// and results come back newest first. Not thread-safe: callers serialize
+// writers against readers.
+// ============================================================================
+
+class SearchIndex
+{
+public:
+    struct Options {
+        int prefixExpansions = 256;   // Terms a prefix may expand to
+    };
+
+    explicit SearchIndex(const Options& options = Options());
+
+    void clear();
+
+    // Indexes one post; returns its document id
+    quint32 addDocument(const QString& username, const QString& content);
+
+    int documentCount() const { return int(m_documentCount); }
+    int termCount() const { return m_terms.size(); }
+    quint64 postingBytes() const;
+
+    // Documents containing every word of the query (the last one as a
+    // prefix unless the query ends in a space), newest first
+    QVector<quint32> search(const QString& query, int limit) const;
+
+    // Author names starting with the prefix (case-insensitive)
+    QStringList searchUsers(const QString& prefix, int limit) const;
+
+    // Case-folded words of the text, in order
+    static QStringList tokenize(const QString& text);
+
+private:
+    struct Block {
+        quint32 first;     // First document id, stored raw
+        quint32 offset;    // Start of the following deltas in data
+        quint32 count;
+    };
+
+    struct PostingList {
+        QByteArray data;        // Varint deltas
+        QVector<Block> blocks;
+        quint32 last = 0;
+        quint32 count = 0;
+
+        void append(quint32 doc);
+    };
+
+    class Cursor;
+    class Group;
+
+    Options m_options;
+    QMap<QString, PostingList> m_terms;
+    QMap<QString, QString> m_users;   // Folded name -> name
+    quint32 m_documentCount = 0;
+};
+
+#endif // SEARCHINDEX_H
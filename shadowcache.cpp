@@ -0,0 +1,142 @@
+#include "shadowcache.h"
+#include <QImage>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QVector>
+#include <QtMath>
+#include <qdrawutil.h>
+
+namespace {
+
+const int BlurPasses = 3;   // Three box blurs approximate a gaussian
+
+// One box-blur pass over a row or column of alpha values
+void boxBlurLine(int* line, int length, int stride, int radius, QVector<int>& scratch)
+{
+    scratch.resize(length);
+    const int window = 2 * radius + 1;
+    int sum = 0;
+    for (int i = 0; i < qMin(radius, length); ++i) {
+        sum += line[i * stride];
+    }
+    for (int i = 0; i < length; ++i) {
+        if (i + radius < length) {
+            sum += line[(i + radius) * stride];
+        }
+        scratch[i] = sum / window;
+        if (i - radius >= 0) {
+            sum -= line[(i - radius) * stride];
+        }
+    }
+    for (int i = 0; i < length; ++i) {
+        line[i * stride] = scratch[i];
+    }
+}
+
+void blurAlpha(QVector<int>& alpha, int width, int height, int radius)
+{
+    if (radius <= 0) {
+        return;
+    }
+    QVector<int> scratch;
+    for (int pass = 0; pass < BlurPasses; ++pass) {
+        for (int y = 0; y < height; ++y) {
+            boxBlurLine(alpha.data() + y * width, width, 1, radius, scratch);
+        }
+        for (int x = 0; x < width; ++x) {
+            boxBlurLine(alpha.data() + x, height, width, radius, scratch);
+        }
+    }
+}
+
+// Pixels the blur spreads past the shape edge (device independent)
+int blurExtent(const ShadowCache::Style& style)
+{
+    return qMax(0, style.blurRadius);
+}
+
+QString cacheKey(const ShadowCache::Style& style, qreal dpr)
+{
+    return QString("shadow:%1:%2:%3@%4")
+        .arg(style.blurRadius).arg(style.cornerRadius)
+        .arg(style.color.rgba(), 8, 16, QChar('0')).arg(dpr);
+}
+
+} // namespace
+
+QMargins ShadowCache::margins(const Style& style)
+{
+    const int extent = blurExtent(style);
+    return QMargins(qMax(0, extent - style.offset.x()), qMax(0, extent - style.offset.y()),
+                    qMax(0, extent + style.offset.x()), qMax(0, extent + style.offset.y()));
+}
+
+QPixmap ShadowCache::ninePatch(const Style& style, qreal devicePixelRatio)
+{
+    const QString key = cacheKey(style, devicePixelRatio);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    // Smallest rounded rect that still has both corners plus a 1px middle
+    const int extent = blurExtent(style);
+    const int border = extent + style.cornerRadius;
+    const int side = 2 * border + 1;
+    const int deviceSide = qCeil(side * devicePixelRatio);
+
+    QImage shape(deviceSide, deviceSide, QImage::Format_ARGB32_Premultiplied);
+    shape.fill(Qt::transparent);
+    {
+        QPainter painter(&shape);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.scale(devicePixelRatio, devicePixelRatio);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(Qt::black);
+        painter.drawRoundedRect(QRectF(extent, extent, 2 * style.cornerRadius + 1, 2 * style.cornerRadius + 1),
+                                style.cornerRadius, style.cornerRadius);
+    }
+
+    QVector<int> alpha(deviceSide * deviceSide);
+    for (int y = 0; y < deviceSide; ++y) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(shape.constScanLine(y));
+        for (int x = 0; x < deviceSide; ++x) {
+            alpha[y * deviceSide + x] = qAlpha(line[x]);
+        }
+    }
+    // Each box pass spreads by its radius, so three passes cover the extent
+    blurAlpha(alpha, deviceSide, deviceSide, qRound(extent * devicePixelRatio / BlurPasses));
+
+    const QColor& c = style.color;
+    for (int y = 0; y < deviceSide; ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(shape.scanLine(y));
+        for (int x = 0; x < deviceSide; ++x) {
+            const int a = alpha[y * deviceSide + x] * c.alpha() / 255;
+            line[x] = qPremultiply(qRgba(c.red(), c.green(), c.blue(), a));
+        }
+    }
+
+    pixmap = QPixmap::fromImage(shape);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+void ShadowCache::paint(QPainter* painter, const QRect& shape, const Style& style)
+{
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const QPixmap patch = ninePatch(style, dpr);
+
+    const int extent = blurExtent(style);
+    const int border = extent + style.cornerRadius;
+    const QMargins patchMargins(border, border, border, border);
+    const QRect target = shape.translated(style.offset)
+                              .adjusted(-extent, -extent, extent, extent);
+
+    // Shapes smaller than the corners would fold the nine-patch over itself
+    if (target.width() < 2 * border || target.height() < 2 * border) {
+        painter->drawPixmap(target, patch);
+        return;
+    }
+    qDrawBorderPixmap(painter, target, patchMargins, patch);
+}
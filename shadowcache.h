@@ -0,0 +1,45 @@
+#ifndef SHADOWCACHE_H
+#define SHADOWCACHE_H
+
+#include <QColor>
+#include <QMargins>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+
+class QPainter;
+
+// ============================================================================
+// SHADOW CACHE
+// Drop shadows for rounded rectangles without QGraphicsDropShadowEffect.
+// The shadow of a rounded rect only varies along its corners, so it is
+// blurred once into a small nine-patch (corners, edges, 1px center) per
+// (blur radius, corner radius, color, device pixel ratio) and stretched
+// around any card size with qDrawBorderPixmap. Painting a shadow is then
+// nine pixmap blits and never an offscreen blur.
+// ============================================================================
+
+class ShadowCache
+{
+public:
+    struct Style {
+        int blurRadius;      // Same meaning as QGraphicsDropShadowEffect
+        int cornerRadius;    // Corner radius of the shape casting the shadow
+        QPoint offset;
+        QColor color;
+    };
+
+    // How far the shadow reaches outside the shape on each side
+    static QMargins margins(const Style& style);
+
+    // Blurred nine-patch for style, built on first use
+    static QPixmap ninePatch(const Style& style, qreal devicePixelRatio);
+
+    // Paints the shadow that shape would cast
+    static void paint(QPainter* painter, const QRect& shape, const Style& style);
+
+private:
+    ShadowCache() = delete;
+};
+
+#endif // SHADOWCACHE_H
@@ -0,0 +1,21 @@
+#include "shadowframe.h"
+#include <QPainter>
+#include <QVBoxLayout>
+
+ShadowFrame::ShadowFrame(QWidget *content, const ShadowCache::Style &style, QWidget *parent)
+    : QWidget(parent)
+    , m_content(content)
+    , m_style(style)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(ShadowCache::margins(style));
+    layout->setSpacing(0);
+    layout->addWidget(content);
+}
+
+void ShadowFrame::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    ShadowCache::paint(&painter, m_content->geometry(), m_style);
+}
@@ -0,0 +1,32 @@
+#ifndef SHADOWFRAME_H
+#define SHADOWFRAME_H
+
+#include <QWidget>
+#include "shadowcache.h"
+
+// ============================================================================
+// SHADOW FRAME
+// Wraps one widget and paints a cached drop shadow behind it, leaving just
+// enough margin for the shadow. Replaces QGraphicsDropShadowEffect, which
+// re-renders and blurs the whole child offscreen on every repaint.
+// ============================================================================
+
+class ShadowFrame : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ShadowFrame(QWidget *content, const ShadowCache::Style &style,
+                         QWidget *parent = nullptr);
+
+    QWidget* content() const { return m_content; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QWidget* m_content;
+    ShadowCache::Style m_style;
+};
+
+#endif // SHADOWFRAME_H
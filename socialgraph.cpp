@@ -0,0 +1,521 @@
+#include "socialgraph.h"
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char SocialGraphMagic[8] = { 'P', 'S', 'G', 'R', 'A', 'P', 'H', '1' };
+const quint32 SocialGraphVersion = 1;
+const int DenseMinimum = 64;   // Never use a bitset for fewer close friends than this
+
+static_assert(sizeof(SocialGraphHeader) == 48, "graph.dat header layout changed");
+
+quint64 align8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+struct Sections {
+    quint64 outOffsets;
+    quint64 outTargets;
+    quint64 inOffsets;
+    quint64 inSources;
+    quint64 closeFriends;
+    quint64 end;
+};
+
+Sections sectionsFor(quint64 nodeCount, quint64 edgeCount, quint64 closeFriendCount)
+{
+    const quint64 offsetsBytes = (nodeCount + 1) * sizeof(quint32);
+    const quint64 edgesBytes = edgeCount * sizeof(quint32);
+    Sections s;
+    s.outOffsets = sizeof(SocialGraphHeader);
+    s.outTargets = align8(s.outOffsets + offsetsBytes);
+    s.inOffsets = align8(s.outTargets + edgesBytes);
+    s.inSources = align8(s.inOffsets + offsetsBytes);
+    s.closeFriends = align8(s.inSources + edgesBytes);
+    s.end = s.closeFriends + closeFriendCount * 2 * sizeof(quint32);
+    return s;
+}
+
+// Rows::begin/end/contains index with these unchecked: offsets must start
+// at 0, never decrease and stay within the edges, and every neighbor must
+// be a node
+bool validRows(const quint32* offsets, const quint32* targets, quint32 nodeCount, quint64 edgeCount)
+{
+    if (offsets[0] != 0 || offsets[nodeCount] != edgeCount) {
+        return false;
+    }
+    for (quint32 user = 0; user < nodeCount; ++user) {
+        if (offsets[user + 1] < offsets[user]) {
+            return false;
+        }
+    }
+    for (quint64 i = 0; i < edgeCount; ++i) {
+        if (targets[i] >= nodeCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// ROWS
+// ============================================================================
+
+int SocialGraph::Rows::degree(quint32 user) const
+{
+    return user < nodeCount ? int(offsets[user + 1] - offsets[user]) : 0;
+}
+
+const quint32* SocialGraph::Rows::begin(quint32 user) const
+{
+    return user < nodeCount ? targets + offsets[user] : nullptr;
+}
+
+const quint32* SocialGraph::Rows::end(quint32 user) const
+{
+    return user < nodeCount ? targets + offsets[user + 1] : nullptr;
+}
+
+bool SocialGraph::Rows::contains(quint32 user, quint32 other) const
+{
+    return user < nodeCount && std::binary_search(begin(user), end(user), other);
+}
+
+// ============================================================================
+// FILE
+// ============================================================================
+
+SocialGraph::SocialGraph()
+{
+}
+
+SocialGraph::~SocialGraph()
+{
+    close();
+}
+
+bool SocialGraph::open(const QString& path)
+{
+    close();
+
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    m_error = "graph.dat is little-endian; big-endian hosts are not supported";
+    return false;
+#endif
+
+    m_file.setFileName(path);
+    if (!m_file.exists()) {
+        return true;   // Empty graph until the first save
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    const quint64 fileSize = quint64(m_file.size());
+    m_map = fileSize >= sizeof(SocialGraphHeader) ? m_file.map(0, m_file.size()) : nullptr;
+    if (!m_map) {
+        m_error = "graph.dat is truncated";
+        close();
+        return false;
+    }
+
+    // Header and section bounds first, then one pass over the rows: a
+    // corrupt file is refused here rather than read out of bounds later
+    const SocialGraphHeader* header = reinterpret_cast<const SocialGraphHeader*>(m_map);
+    const bool sane = std::memcmp(header->magic, SocialGraphMagic, sizeof(SocialGraphMagic)) == 0
+        && header->version == SocialGraphVersion
+        && header->nodeCount < quint64(std::numeric_limits<quint32>::max())
+        && header->nodeCount < fileSize && header->edgeCount < fileSize
+        && header->closeFriendCount < fileSize;
+    const Sections s = sane ? sectionsFor(header->nodeCount, header->edgeCount, header->closeFriendCount)
+                            : Sections();
+    if (!sane || s.end > fileSize) {
+        m_error = "graph.dat has an invalid header";
+        close();
+        return false;
+    }
+
+    m_nodeCount = quint32(header->nodeCount);
+    m_baseEdges = header->edgeCount;
+    m_out.nodeCount = m_in.nodeCount = m_nodeCount;
+    m_out.offsets = reinterpret_cast<const quint32*>(m_map + s.outOffsets);
+    m_out.targets = reinterpret_cast<const quint32*>(m_map + s.outTargets);
+    m_in.offsets = reinterpret_cast<const quint32*>(m_map + s.inOffsets);
+    m_in.targets = reinterpret_cast<const quint32*>(m_map + s.inSources);
+    if (!validRows(m_out.offsets, m_out.targets, m_nodeCount, m_baseEdges)
+        || !validRows(m_in.offsets, m_in.targets, m_nodeCount, m_baseEdges)) {
+        m_error = "graph.dat has inconsistent rows";
+        close();
+        return false;
+    }
+
+    // An out-of-range id would size a bitset from it
+    const quint32* pairs = reinterpret_cast<const quint32*>(m_map + s.closeFriends);
+    const quint64 closeFriendCount = header->closeFriendCount;
+    for (quint64 i = 0; i < 2 * closeFriendCount; ++i) {
+        if (pairs[i] >= m_nodeCount) {
+            m_error = "graph.dat has a close friend outside the graph";
+            close();
+            return false;
+        }
+    }
+    for (quint64 i = 0; i < closeFriendCount; ++i) {
+        setCloseFriend(pairs[2 * i], pairs[2 * i + 1], true);
+    }
+
+    m_error.clear();
+    return true;
+}
+
+void SocialGraph::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_out = Rows();
+    m_in = Rows();
+    m_baseEdges = 0;
+    m_ownedStorage.clear();
+    m_nodeCount = 0;
+    m_addedOut.clear();
+    m_addedIn.clear();
+    m_removed.clear();
+    m_outDelta.clear();
+    m_inDelta.clear();
+    m_edgeDelta = 0;
+    m_closeFriends.clear();
+}
+
+bool SocialGraph::save(const QString& path)
+{
+    // Rows are rebuilt into memory first, which also releases the mapping
+    // of the file about to be replaced
+    rebuildRows();
+
+    QVector<quint32> pairs;
+    QList<quint32> users = m_closeFriends.keys();
+    std::sort(users.begin(), users.end());
+    for (quint32 user : users) {
+        QList<quint32> friends = closeFriendSet(user).values();
+        std::sort(friends.begin(), friends.end());
+        for (quint32 friendId : friends) {
+            pairs.append(user);
+            pairs.append(friendId);
+        }
+    }
+
+    SocialGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SocialGraphMagic, sizeof(SocialGraphMagic));
+    header.version = SocialGraphVersion;
+    header.nodeCount = m_nodeCount;
+    header.edgeCount = m_baseEdges;
+    header.closeFriendCount = quint64(pairs.size() / 2);
+    const Sections s = sectionsFor(header.nodeCount, header.edgeCount, header.closeFriendCount);
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+
+    auto writeAt = [&file](quint64 offset, const void* data, quint64 size) {
+        const QByteArray padding(int(offset - quint64(file.pos())), '\0');
+        return file.write(padding) == padding.size()
+            && file.write(static_cast<const char*>(data), qint64(size)) == qint64(size);
+    };
+    const quint64 offsetsBytes = (quint64(m_nodeCount) + 1) * sizeof(quint32);
+    const quint64 edgesBytes = m_baseEdges * sizeof(quint32);
+
+    const bool ok = writeAt(0, &header, sizeof(header))
+        && writeAt(s.outOffsets, m_out.offsets, offsetsBytes)
+        && writeAt(s.outTargets, m_out.targets, edgesBytes)
+        && writeAt(s.inOffsets, m_in.offsets, offsetsBytes)
+        && writeAt(s.inSources, m_in.targets, edgesBytes)
+        && writeAt(s.closeFriends, pairs.constData(), quint64(pairs.size()) * sizeof(quint32));
+
+    if (!ok || !file.commit()) {
+        m_error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// FOLLOWS
+// ============================================================================
+
+quint64 SocialGraph::edgeCount() const
+{
+    return quint64(qint64(m_baseEdges) + m_edgeDelta);
+}
+
+bool SocialGraph::follow(quint32 follower, quint32 followee)
+{
+    if (follower == followee || isFollowing(follower, followee)) {
+        return false;
+    }
+    grow(qMax(follower, followee));
+
+    // Re-following a base edge just cancels its removal
+    if (!m_removed.remove(edgeKey(follower, followee))) {
+        m_addedOut[follower].insert(followee);
+        m_addedIn[followee].insert(follower);
+    }
+    ++m_outDelta[follower];
+    ++m_inDelta[followee];
+    ++m_edgeDelta;
+    return true;
+}
+
+bool SocialGraph::unfollow(quint32 follower, quint32 followee)
+{
+    if (!isFollowing(follower, followee)) {
+        return false;
+    }
+
+    auto added = m_addedOut.find(follower);
+    if (added != m_addedOut.end() && added->remove(followee)) {
+        if (added->isEmpty()) {
+            m_addedOut.erase(added);
+        }
+        auto addedIn = m_addedIn.find(followee);
+        addedIn->remove(follower);
+        if (addedIn->isEmpty()) {
+            m_addedIn.erase(addedIn);
+        }
+    } else {
+        m_removed.insert(edgeKey(follower, followee));
+    }
+    --m_outDelta[follower];
+    --m_inDelta[followee];
+    --m_edgeDelta;
+    return true;
+}
+
+bool SocialGraph::isFollowing(quint32 follower, quint32 followee) const
+{
+    auto added = m_addedOut.constFind(follower);
+    if (added != m_addedOut.constEnd() && added->contains(followee)) {
+        return true;
+    }
+    return m_out.contains(follower, followee) && !m_removed.contains(edgeKey(follower, followee));
+}
+
+int SocialGraph::followingCount(quint32 user) const
+{
+    return m_out.degree(user) + m_outDelta.value(user);
+}
+
+int SocialGraph::followerCount(quint32 user) const
+{
+    return m_in.degree(user) + m_inDelta.value(user);
+}
+
+QVector<quint32> SocialGraph::following(quint32 user) const
+{
+    return row(m_out, m_addedOut, m_removed, user, false);
+}
+
+QVector<quint32> SocialGraph::followers(quint32 user) const
+{
+    return row(m_in, m_addedIn, m_removed, user, true);
+}
+
+QVector<quint32> SocialGraph::row(const Rows& base, const QHash<quint32, QSet<quint32>>& added,
+                                  const QSet<quint64>& removed, quint32 user, bool reversed)
+{
+    QVector<quint32> result;
+    result.reserve(base.degree(user));
+    for (const quint32* p = base.begin(user); p != base.end(user); ++p) {
+        const quint64 key = reversed ? edgeKey(*p, user) : edgeKey(user, *p);
+        if (removed.isEmpty() || !removed.contains(key)) {
+            result.append(*p);
+        }
+    }
+
+    auto extra = added.constFind(user);
+    if (extra != added.constEnd()) {
+        const int baseSize = result.size();
+        for (quint32 other : extra.value()) {
+            result.append(other);
+        }
+        std::sort(result.begin() + baseSize, result.end());
+        std::inplace_merge(result.begin(), result.begin() + baseSize, result.end());
+    }
+    return result;
+}
+
+void SocialGraph::grow(quint32 user)
+{
+    m_nodeCount = qMax(m_nodeCount, user + 1);
+}
+
+void SocialGraph::rebuildRows()
+{
+    const quint64 edges = edgeCount();
+    const quint32 nodes = m_nodeCount;
+    const quint64 offsetsSize = quint64(nodes) + 1;
+
+    // One block: out offsets, out targets, in offsets, in sources
+    QVector<quint32> storage(int(2 * (offsetsSize + edges)));
+    quint32* outOffsets = storage.data();
+    quint32* outTargets = outOffsets + offsetsSize;
+    quint32* inOffsets = outTargets + edges;
+    quint32* inSources = inOffsets + offsetsSize;
+
+    auto fill = [&](const Rows& base, const QHash<quint32, QSet<quint32>>& added, bool reversed,
+                    quint32* offsets, quint32* targets) {
+        quint32 position = 0;
+        for (quint32 user = 0; user < nodes; ++user) {
+            offsets[user] = position;
+            const QVector<quint32> merged = row(base, added, m_removed, user, reversed);
+            std::copy(merged.begin(), merged.end(), targets + position);
+            position += quint32(merged.size());
+        }
+        offsets[nodes] = position;
+    };
+    fill(m_out, m_addedOut, false, outOffsets, outTargets);
+    fill(m_in, m_addedIn, true, inOffsets, inSources);
+
+    // Drop the mapping and the overlay; the new rows replace both
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_ownedStorage.swap(storage);
+    m_out = { outOffsets, outTargets, nodes };
+    m_in = { inOffsets, inSources, nodes };
+    m_baseEdges = edges;
+    m_addedOut.clear();
+    m_addedIn.clear();
+    m_removed.clear();
+    m_outDelta.clear();
+    m_inDelta.clear();
+    m_edgeDelta = 0;
+}
+
+// ============================================================================
+// CLOSE FRIENDS
+// ============================================================================
+
+bool SocialGraph::setCloseFriend(quint32 user, quint32 friendId, bool closeFriend)
+{
+    if (user == friendId || isCloseFriend(user, friendId) == closeFriend) {
+        return false;
+    }
+    grow(qMax(user, friendId));
+
+    CloseFriends& set = m_closeFriends[user];
+    if (!set.bits.isEmpty()) {
+        if (int(friendId) >= set.bits.size()) {
+            set.bits.resize(int(m_nodeCount));
+        }
+        set.bits.setBit(int(friendId), closeFriend);
+    } else {
+        auto it = std::lower_bound(set.sorted.begin(), set.sorted.end(), friendId);
+        if (closeFriend) {
+            set.sorted.insert(it, friendId);
+        } else {
+            set.sorted.erase(it);
+        }
+    }
+    set.count += closeFriend ? 1 : -1;
+
+    if (set.count == 0) {
+        m_closeFriends.remove(user);
+        return true;
+    }
+
+    // Switch representation when the other one is clearly smaller: a bitset
+    // costs nodeCount/8 bytes, a sorted vector 4 bytes per friend
+    const quint64 bitsetBytes = m_nodeCount / 8 + 1;
+    if (set.bits.isEmpty() && set.count >= DenseMinimum && quint64(set.count) * 4 > bitsetBytes) {
+        set.bits = QBitArray(int(m_nodeCount));
+        for (quint32 id : set.sorted) {
+            set.bits.setBit(int(id));
+        }
+        set.sorted.clear();
+        set.sorted.squeeze();
+    } else if (!set.bits.isEmpty() && quint64(set.count) * 8 < bitsetBytes) {
+        for (int id = 0; id < set.bits.size(); ++id) {
+            if (set.bits.testBit(id)) {
+                set.sorted.append(quint32(id));
+            }
+        }
+        set.bits = QBitArray();
+    }
+    return true;
+}
+
+bool SocialGraph::isCloseFriend(quint32 user, quint32 friendId) const
+{
+    auto it = m_closeFriends.constFind(user);
+    if (it == m_closeFriends.constEnd()) {
+        return false;
+    }
+    if (!it->bits.isEmpty()) {
+        return int(friendId) < it->bits.size() && it->bits.testBit(int(friendId));
+    }
+    return std::binary_search(it->sorted.begin(), it->sorted.end(), friendId);
+}
+
+int SocialGraph::closeFriendCount(quint32 user) const
+{
+    auto it = m_closeFriends.constFind(user);
+    return it == m_closeFriends.constEnd() ? 0 : it->count;
+}
+
+QSet<quint32> SocialGraph::closeFriendSet(quint32 user) const
+{
+    QSet<quint32> result;
+    auto it = m_closeFriends.constFind(user);
+    if (it == m_closeFriends.constEnd()) {
+        return result;
+    }
+    result.reserve(it->count);
+    if (!it->bits.isEmpty()) {
+        for (int id = 0; id < it->bits.size(); ++id) {
+            if (it->bits.testBit(id)) {
+                result.insert(quint32(id));
+            }
+        }
+    } else {
+        for (quint32 id : it->sorted) {
+            result.insert(id);
+        }
+    }
+    return result;
+}
+
+void SocialGraph::appendCloseFriends(quint32 user, std::pmr::vector<quint32>* out) const
+{
+    auto it = m_closeFriends.constFind(user);
+    if (it == m_closeFriends.constEnd()) {
+        return;
+    }
+    out->reserve(out->size() + size_t(it->count));
+    if (!it->bits.isEmpty()) {
+        for (int id = 0; id < it->bits.size(); ++id) {
+            if (it->bits.testBit(id)) {
+                out->push_back(quint32(id));
+            }
+        }
+    } else {
+        out->insert(out->end(), it->sorted.begin(), it->sorted.end());
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef SOCIALGRAPH_H
+#define SOCIALGRAPH_H
+
+#include <QBitArray>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <memory_resource>
+#include <vector>
+
+// ============================================================================
+// SOCIAL GRAPH (graph.dat)
+// Follow edges and close-friend sets over dense user ids.
+//
+// Follows are kept as compressed sparse rows in both directions: an
+// offsets array (one entry per user plus one) into a flat array of sorted
+// neighbor ids, so a user's following/follower list is one contiguous
+// slice, isFollowing is a binary search in it and degrees are one
+// subtraction. 10M edges take ~80 MB (4 bytes per edge per direction).
+// The base rows are memory-mapped from graph.dat; follows and unfollows
+// since the last save live in a small overlay (added/removed edges plus
+// per-user degree deltas, so counts stay O(1)) that save() folds back in.
+//
+// Each user's close friends are a sorted id vector while small and switch
+// to a bitset over all user ids once that is the smaller of the two, so
+// membership is a binary search over a short vector or a single bit test.
+//
+// File layout (little-endian, 8-byte aligned sections):
+//   [SocialGraphHeader]
+//   [quint32 x nodeCount+1]  following offsets
+//   [quint32 x edgeCount]    following targets (sorted per row)
+//   [quint32 x nodeCount+1]  follower offsets
+//   [quint32 x edgeCount]    follower sources (sorted per row)
+//   [quint32 pair x closeFriendCount]  (user, friend), sorted
+//
+// Not thread-safe: callers serialize writers against readers.
+// ============================================================================
+
+struct SocialGraphHeader {
+    char magic[8];
+    quint32 version;
+    quint32 reserved;
+    quint64 nodeCount;
+    quint64 edgeCount;
+    quint64 closeFriendCount;
+    quint64 reserved2;
+};
+
+class SocialGraph
+{
+public:
+    SocialGraph();
+    ~SocialGraph();
+
+    // Maps graph.dat; a missing file opens an empty graph
+    bool open(const QString& path);
+    void close();
+    QString errorString() const { return m_error; }
+
+    // Folds the overlay into new rows and writes them to graph.dat
+    bool save(const QString& path);
+
+    quint32 nodeCount() const { return m_nodeCount; }
+    quint64 edgeCount() const;
+
+    // Follows (return false when nothing changed)
+    bool follow(quint32 follower, quint32 followee);
+    bool unfollow(quint32 follower, quint32 followee);
+    bool isFollowing(quint32 follower, quint32 followee) const;
+    int followingCount(quint32 user) const;
+    int followerCount(quint32 user) const;
+    QVector<quint32> following(quint32 user) const;
+    QVector<quint32> followers(quint32 user) const;
+
+    // Close friends (return false when nothing changed)
+    bool setCloseFriend(quint32 user, quint32 friendId, bool closeFriend);
+    bool isCloseFriend(quint32 user, quint32 friendId) const;
+    int closeFriendCount(quint32 user) const;
+    QSet<quint32> closeFriendSet(quint32 user) const;
+    // Appends them in ascending id order, without a hash node per friend
+    void appendCloseFriends(quint32 user, std::pmr::vector<quint32>* out) const;
+
+private:
+    Q_DISABLE_COPY(SocialGraph)
+
+    struct Rows {
+        const quint32* offsets = nullptr;   // nodeCount + 1 entries
+        const quint32* targets = nullptr;
+        quint32 nodeCount = 0;
+
+        int degree(quint32 user) const;
+        const quint32* begin(quint32 user) const;
+        const quint32* end(quint32 user) const;
+        bool contains(quint32 user, quint32 other) const;
+    };
+
+    struct CloseFriends {
+        QVector<quint32> sorted;   // Used while small
+        QBitArray bits;            // Used once denser than 1 in 32 ids
+        int count = 0;
+    };
+
+    static quint64 edgeKey(quint32 from, quint32 to) { return (quint64(from) << 32) | to; }
+    static QVector<quint32> row(const Rows& base, const QHash<quint32, QSet<quint32>>& added,
+                                const QSet<quint64>& removed, quint32 user, bool reversed);
+
+    void grow(quint32 user);
+    void rebuildRows();
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    QString m_error;
+
+    // Base rows (mapped from graph.dat, or owned after a rebuild)
+    Rows m_out;
+    Rows m_in;
+    quint64 m_baseEdges = 0;
+    QVector<quint32> m_ownedStorage;
+    quint32 m_nodeCount = 0;
+
+    // Changes since the base rows were built
+    QHash<quint32, QSet<quint32>> m_addedOut;
+    QHash<quint32, QSet<quint32>> m_addedIn;
+    QSet<quint64> m_removed;               // Base edges that were unfollowed
+    QHash<quint32, int> m_outDelta;
+    QHash<quint32, int> m_inDelta;
+    qint64 m_edgeDelta = 0;
+
+    QHash<quint32, CloseFriends> m_closeFriends;
+};
+
+#endif // SOCIALGRAPH_H
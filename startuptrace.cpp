@@ -0,0 +1,136 @@
+#include "startuptrace.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+#include <cstdio>
+
+namespace {
+
+const char* const TraceVariable = "PRIORITY_SOCIAL_STARTUP_TRACE";
+const char* const BudgetVariable = "PRIORITY_SOCIAL_STARTUP_BUDGET_MS";
+
+struct PhaseRecord {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+struct TraceState {
+    QElapsedTimer clock;
+    bool enabled = false;
+    bool finished = false;
+    QByteArray output;
+    qint64 budgetMs = 0;
+    qint64 firstFrameNs = -1;
+    qint64 interactiveNs = -1;
+    QVector<PhaseRecord> phases;
+
+    TraceState()
+    {
+        clock.start();
+        output = qgetenv(TraceVariable);
+        enabled = !output.isEmpty();
+        budgetMs = qEnvironmentVariableIntValue(BudgetVariable);
+    }
+};
+
+TraceState& state()
+{
+    static TraceState trace;
+    return trace;
+}
+
+// Starts the clock during static initialization rather than on first use
+const bool ClockStarted = (state(), true);
+
+double toMs(qint64 ns)
+{
+    return ns < 0 ? -1.0 : ns / 1e6;
+}
+
+} // namespace
+
+StartupTrace::Phase::Phase(const char* name)
+    : m_name(name)
+    , m_startNs(state().enabled ? state().clock.nsecsElapsed() : 0)
+    , m_scope(name)
+{
+}
+
+StartupTrace::Phase::~Phase()
+{
+    TraceState& trace = state();
+    if (trace.enabled && !trace.finished) {
+        trace.phases.append({ m_name, m_startNs, trace.clock.nsecsElapsed() - m_startNs });
+    }
+}
+
+bool StartupTrace::isEnabled()
+{
+    return state().enabled;
+}
+
+void StartupTrace::markFirstFrame()
+{
+    TraceState& trace = state();
+    if (trace.enabled && trace.firstFrameNs < 0) {
+        trace.firstFrameNs = trace.clock.nsecsElapsed();
+    }
+}
+
+void StartupTrace::markInteractive()
+{
+    TraceState& trace = state();
+    if (trace.enabled && trace.interactiveNs < 0) {
+        trace.interactiveNs = trace.clock.nsecsElapsed();
+    }
+}
+
+void StartupTrace::finish()
+{
+    TraceState& trace = state();
+    if (!trace.enabled || trace.finished) {
+        return;
+    }
+    trace.finished = true;
+    const qint64 nowNs = trace.clock.nsecsElapsed();
+
+    QJsonArray phases;
+    for (const PhaseRecord& phase : trace.phases) {
+        phases.append(QJsonObject{
+            { "name", QString::fromLatin1(phase.name) },
+            { "startMs", toMs(phase.startNs) },
+            { "durationMs", toMs(phase.durationNs) }
+        });
+    }
+
+    QJsonObject report{
+        { "phases", phases },
+        { "timeToFirstFrameMs", toMs(trace.firstFrameNs) },
+        { "timeToInteractiveMs", toMs(trace.interactiveNs) },
+        { "timeToAllPagesMs", toMs(nowNs) }
+    };
+    if (trace.budgetMs > 0) {
+        const bool withinBudget = trace.interactiveNs >= 0 && toMs(trace.interactiveNs) <= trace.budgetMs;
+        report.insert("budgetMs", double(trace.budgetMs));
+        report.insert("withinBudget", withinBudget);
+        if (!withinBudget) {
+            qWarning() << "Startup over budget:" << toMs(trace.interactiveNs) << "ms to interactive, budget"
+                       << trace.budgetMs << "ms";
+        }
+    }
+
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (trace.output == "-") {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stderr);
+        return;
+    }
+    QFile file(QString::fromLocal8Bit(trace.output));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qDebug() << "Could not write startup trace" << file.fileName() << ":" << file.errorString();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include "trace.h"
+#include <QtGlobal>
+
+// ============================================================================
+// STARTUP TRACE
+// Cold-start timings for the launcher's budget check. Off unless
+// PRIORITY_SOCIAL_STARTUP_TRACE names an output file ("-" for stderr);
+// when off, every call is a single branch.
+//
+// The report is JSON, in milliseconds since static initialization (just
+// before main):
+//   phases               scoped construction steps (backend, each page)
+//   timeToFirstFrameMs   first paint of the login screen
+//   timeToInteractiveMs  first event loop turn after that frame
+//   timeToAllPagesMs     last page built, in idle time or on demand
+// With PRIORITY_SOCIAL_STARTUP_BUDGET_MS set it also records whether time
+// to interactive stayed within the budget, and logs a warning if not.
+//
+// Phases are also Trace scopes, so page builds show up in hot-path traces.
+//
+// GUI thread only.
+// ============================================================================
+
+class StartupTrace
+{
+public:
+    // Records the time from construction to destruction under name, in
+    // this report and as a Trace scope
+    class Phase
+    {
+    public:
+        explicit Phase(const char* name);
+        ~Phase();
+
+    private:
+        Q_DISABLE_COPY(Phase)
+
+        const char* m_name;
+        qint64 m_startNs;
+        Trace::Scope m_scope;
+    };
+
+    static bool isEnabled();
+
+    static void markFirstFrame();
+    static void markInteractive();
+
+    // Writes the report; later calls do nothing
+    static void finish();
+};
+
+#endif // STARTUPTRACE_H
@@ -0,0 +1,88 @@
+#include "storydelegate.h"
+#include "storymodel.h"
+#include "appstyle.h"
+#include "imagecache.h"
+#include <QFontMetrics>
+#include <QPainter>
+
+namespace {
+
+const int CircleSize = 64;
+const int RingWidth = 4;
+const int NameSpacing = 5;
+
+} // namespace
+
+StoryDelegate::StoryDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void StoryDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const
+{
+    const AppStyle::PaintPalette& palette = AppStyle::paintPalette();
+    const bool own = index.data(StoryModel::OwnRole).toBool();
+    const bool hasStories = index.data(StoryModel::CountRole).toInt() > 0;
+
+    const QRect circle(option.rect.left() + (option.rect.width() - CircleSize) / 2, option.rect.top(),
+                       CircleSize, CircleSize);
+    const QRect avatar = circle.adjusted(RingWidth, RingWidth, -RingWidth, -RingWidth);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setPen(Qt::NoPen);
+
+    // Ring
+    if (hasStories) {
+        painter->setBrush(index.data(StoryModel::SeenRole).toBool() ? palette.seenRing
+                          : index.data(StoryModel::CloseFriendRole).toBool() ? palette.closeFriendRing
+                                                                             : palette.storyRingGradient);
+        painter->drawEllipse(circle);
+    }
+
+    // Avatar (emoji placeholder until the image is decoded)
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const QPixmap picture = m_images
+        ? m_images->pixmap(ImageCache::avatarPath(index.data(StoryModel::UsernameRole).toString()),
+                           avatar.size(), ImageCache::Circle, dpr)
+        : QPixmap();
+    if (!picture.isNull()) {
+        painter->drawPixmap(avatar, picture);
+    } else {
+        painter->setBrush(palette.avatarBackground);
+        painter->drawEllipse(avatar);
+        painter->setPen(palette.textPen);
+        painter->setFont(palette.avatarFont);
+        painter->drawText(avatar, Qt::AlignCenter, QStringLiteral("😊"));
+    }
+
+    // "Add story" badge
+    if (own && !hasStories) {
+        const QRect badge(avatar.right() - 18, avatar.bottom() - 18, 20, 20);
+        painter->setPen(QPen(Qt::white, 2));
+        painter->setBrush(AppStyle::Pink);
+        painter->drawEllipse(badge);
+        painter->setPen(palette.textPen);
+        painter->setFont(palette.buttonFont);
+        painter->drawText(badge, Qt::AlignCenter, QStringLiteral("+"));
+    }
+
+    // Name
+    const QRect nameRect(option.rect.left(), circle.bottom() + 1 + NameSpacing,
+                         option.rect.width(), option.rect.bottom() - circle.bottom() - NameSpacing);
+    painter->setPen(palette.storyNamePen);
+    painter->setFont(palette.storyNameFont);
+    painter->drawText(nameRect, Qt::AlignHCenter | Qt::AlignTop,
+                      QFontMetrics(palette.storyNameFont).elidedText(index.data(Qt::DisplayRole).toString(),
+                                                                     Qt::ElideRight, nameRect.width()));
+    painter->restore();
+}
+
+QSize StoryDelegate::sizeHint(const QStyleOptionViewItem &option,
+                              const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    return QSize(ItemWidth, ItemHeight);
+}
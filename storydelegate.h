@@ -0,0 +1,40 @@
+#ifndef STORYDELEGATE_H
+#define STORYDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class ImageCache;
+
+// ============================================================================
+// STORY DELEGATE
+// Paints a story circle (ring, avatar, name) for the horizontal stories
+// view. Items have one fixed size, so with uniform item sizes the view
+// only ever touches the circles in its viewport.
+//
+// Rings are green for close friends, the pink-to-purple gradient for
+// everyone else and grey once viewed. The viewer's own circle shows a "+"
+// while they have no story.
+// ============================================================================
+
+class StoryDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ItemWidth = 78;
+    static constexpr int ItemHeight = 96;
+
+    explicit StoryDelegate(QObject *parent = nullptr);
+
+    void setImageCache(ImageCache* images) { m_images = images; }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option,
+                   const QModelIndex &index) const override;
+
+private:
+    ImageCache* m_images = nullptr;
+};
+
+#endif // STORYDELEGATE_H
@@ -0,0 +1,84 @@
+#include "storymodel.h"
+#include "timeformatter.h"
+
+StoryModel::StoryModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int StoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rings.size();
+}
+
+QVariant StoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rings.size()) {
+        return QVariant();
+    }
+
+    const StoryRing& ring = m_rings.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return ring.isOwn ? QStringLiteral("You") : ring.username;
+    case UsernameRole:
+        return ring.username;
+    case CountRole:
+        return ring.storyCount;
+    case TimestampRole:
+        return ring.latestAt > 0 ? TimeFormatter::relative(ring.latestAt) : QString();
+    case CloseFriendRole:
+        return ring.isCloseFriend;
+    case OwnRole:
+        return ring.isOwn;
+    case SeenRole:
+        return m_seen.contains(seenKey(ring));
+    case Qt::ToolTipRole:
+        return ring.storyCount > 0
+            ? QString("%1 · %2").arg(ring.username, TimeFormatter::relative(ring.latestAt)) : QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StoryModel::roleNames() const
+{
+    return {
+        { UsernameRole, "username" },
+        { CountRole, "storyCount" },
+        { TimestampRole, "timestamp" },
+        { CloseFriendRole, "isCloseFriend" },
+        { OwnRole, "isOwn" },
+        { SeenRole, "seen" }
+    };
+}
+
+QString StoryModel::seenKey(const StoryRing& ring)
+{
+    return QString("%1:%2").arg(ring.username).arg(ring.storyCount);
+}
+
+void StoryModel::setRings(const QVector<StoryRing>& rings)
+{
+    beginResetModel();
+    m_rings = rings;
+    endResetModel();
+}
+
+void StoryModel::markSeen(int row)
+{
+    if (row < 0 || row >= m_rings.size()) {
+        return;
+    }
+    m_seen.insert(seenKey(m_rings.at(row)));
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { SeenRole });
+}
+
+void StoryModel::refreshTimestamps()
+{
+    if (m_rings.isEmpty()) {
+        return;
+    }
+    emit dataChanged(index(0), index(m_rings.size() - 1), { TimestampRole, Qt::ToolTipRole });
+}
@@ -0,0 +1,50 @@
+#ifndef STORYMODEL_H
+#define STORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QSet>
+#include <QVector>
+#include "datatypes.h"
+
+// ============================================================================
+// STORY MODEL
+// One row per story circle in the stories bar. Rows only carry the ring
+// summary; the stories themselves are fetched when a circle is opened.
+// Viewed rings stay grey for the session until their author posts again.
+// ============================================================================
+
+class StoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        UsernameRole = Qt::UserRole + 1,
+        CountRole,
+        TimestampRole,
+        CloseFriendRole,
+        OwnRole,
+        SeenRole
+    };
+
+    explicit StoryModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setRings(const QVector<StoryRing>& rings);
+    const StoryRing& ringAt(int row) const { return m_rings.at(row); }
+    void markSeen(int row);
+
+    // Relative times moved on: one dataChanged for every ring's time
+    void refreshTimestamps();
+
+private:
+    static QString seenKey(const StoryRing& ring);
+
+    QVector<StoryRing> m_rings;
+    QSet<QString> m_seen;   // Author and story count when last viewed
+};
+
+#endif // STORYMODEL_H
@@ -0,0 +1,119 @@
+#include "storystore.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+StoryStore::StoryStore(const Options& options)
+    : m_options(options)
+{
+}
+
+quint64 StoryStore::add(quint32 authorId, const QString& author, const QString& caption,
+                        const QString& media, qint64 createdAt)
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 id = m_nextId++;
+    const qint64 start = createdAt - createdAt % m_options.bucketSeconds;
+
+    // Stories almost always arrive in time order and land in the last bucket
+    auto bucket = m_buckets.end();
+    if (!m_buckets.empty() && m_buckets.back().start <= start) {
+        if (m_buckets.back().start < start) {
+            m_buckets.push_back({ start, {} });
+        }
+        bucket = m_buckets.end() - 1;
+    } else {
+        bucket = std::lower_bound(m_buckets.begin(), m_buckets.end(), start,
+                                  [](const Bucket& b, qint64 s) { return b.start < s; });
+        if (bucket == m_buckets.end() || bucket->start != start) {
+            bucket = m_buckets.insert(bucket, { start, {} });
+        }
+    }
+    bucket->stories.append(qMakePair(authorId, id));
+
+    std::deque<Story>& stories = m_byAuthor[authorId];
+    const Story story{ id, authorId, author, caption, media, createdAt };
+    if (stories.empty() || stories.back().createdAt <= createdAt) {
+        stories.push_back(story);
+    } else {
+        auto at = std::upper_bound(stories.begin(), stories.end(), createdAt,
+                                   [](qint64 t, const Story& s) { return t < s.createdAt; });
+        stories.insert(at, story);
+    }
+    m_size++;
+    return id;
+}
+
+int StoryStore::sweep(qint64 now)
+{
+    QMutexLocker locker(&m_mutex);
+    int removed = 0;
+    while (!m_buckets.empty()
+           && m_buckets.front().start + m_options.bucketSeconds <= now - m_options.lifetimeSeconds) {
+        for (const auto& entry : m_buckets.front().stories) {
+            auto author = m_byAuthor.find(entry.first);
+            if (author == m_byAuthor.end()) {
+                continue;
+            }
+            std::deque<Story>& stories = author.value();
+            // Expired stories are the author's oldest
+            if (!stories.empty() && stories.front().id == entry.second) {
+                stories.pop_front();
+            } else {
+                auto it = std::find_if(stories.begin(), stories.end(),
+                                       [&entry](const Story& s) { return s.id == entry.second; });
+                if (it == stories.end()) {
+                    continue;
+                }
+                stories.erase(it);
+            }
+            removed++;
+            if (stories.empty()) {
+                m_byAuthor.erase(author);
+            }
+        }
+        m_buckets.pop_front();
+    }
+    m_size -= removed;
+    return removed;
+}
+
+StoryStore::Summary StoryStore::summary(quint32 authorId, qint64 now) const
+{
+    Summary summary;
+    QMutexLocker locker(&m_mutex);
+    auto it = m_byAuthor.constFind(authorId);
+    if (it == m_byAuthor.constEnd()) {
+        return summary;
+    }
+    const std::deque<Story>& stories = it.value();
+    // Only the front can have expired since the last sweep
+    auto live = std::find_if(stories.begin(), stories.end(),
+                             [this, now](const Story& s) { return isLive(s, now); });
+    summary.count = int(stories.end() - live);
+    if (summary.count > 0) {
+        summary.latestAt = stories.back().createdAt;
+    }
+    return summary;
+}
+
+QVector<StoryStore::Story> StoryStore::stories(quint32 authorId, qint64 now) const
+{
+    QVector<Story> result;
+    QMutexLocker locker(&m_mutex);
+    auto it = m_byAuthor.constFind(authorId);
+    if (it == m_byAuthor.constEnd()) {
+        return result;
+    }
+    for (const Story& story : it.value()) {
+        if (isLive(story, now)) {
+            result.append(story);
+        }
+    }
+    return result;
+}
+
+int StoryStore::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
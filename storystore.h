@@ -0,0 +1,86 @@
+#ifndef STORYSTORE_H
+#define STORYSTORE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <deque>
+
+// ============================================================================
+// STORY STORE
+// Stories that disappear after a fixed lifetime (24 hours by default).
+//
+// Each author's live stories are kept oldest first, and every story is also
+// filed in a time bucket (5 minutes wide by default) in a queue of buckets
+// ordered by start time. Expiry never scans: sweep() pops whole buckets off
+// the front of the queue once their newest possible story has expired and
+// drops those stories from the front of their authors' queues, so each
+// story is touched once on the way in and once on the way out.
+//
+// Between sweeps a bucket may still hold a few expired stories; reads skip
+// them, so nothing older than the lifetime is ever returned.
+//
+// Thread-safe.
+// ============================================================================
+
+class StoryStore
+{
+public:
+    struct Story {
+        quint64 id;
+        quint32 authorId;
+        QString author;
+        QString caption;
+        QString media;
+        qint64 createdAt;    // Seconds since epoch
+    };
+
+    struct Summary {
+        int count = 0;        // Live stories
+        qint64 latestAt = 0;
+    };
+
+    struct Options {
+        qint64 lifetimeSeconds = 24 * 3600;
+        qint64 bucketSeconds = 5 * 60;    // Expiry granularity of sweep()
+    };
+
+    explicit StoryStore(const Options& options = Options());
+
+    // Returns the new story's id
+    quint64 add(quint32 authorId, const QString& author, const QString& caption, const QString& media,
+                qint64 createdAt);
+
+    // Drops every bucket that has fully expired; returns the stories removed
+    int sweep(qint64 now);
+
+    Summary summary(quint32 authorId, qint64 now) const;
+
+    // Live stories by the author, oldest first
+    QVector<Story> stories(quint32 authorId, qint64 now) const;
+
+    int size() const;
+
+private:
+    Q_DISABLE_COPY(StoryStore)
+
+    struct Bucket {
+        qint64 start;
+        QVector<QPair<quint32, quint64>> stories;   // (author, story id)
+    };
+
+    bool isLive(const Story& story, qint64 now) const
+    {
+        return story.createdAt > now - m_options.lifetimeSeconds;
+    }
+
+    Options m_options;
+    mutable QMutex m_mutex;
+    std::deque<Bucket> m_buckets;   // Oldest first
+    QHash<quint32, std::deque<Story>> m_byAuthor;
+    quint64 m_nextId = 1;
+    int m_size = 0;
+};
+
+#endif // STORYSTORE_H
@@ -0,0 +1,53 @@
+#include "stringarena.h"
+#include <algorithm>
+
+// ============================================================================
+// STRING ARENA
+// ============================================================================
+
+StringArena::Ref StringArena::add(QStringView text)
+{
+    if (text.isEmpty()) {
+        return Ref();
+    }
+
+    // resize() grows the capacity geometrically, so appends are amortized O(1)
+    const int offset = m_chars.size();
+    m_chars.resize(offset + int(text.size()));
+    std::copy(text.begin(), text.end(), m_chars.begin() + offset);
+    return { quint32(offset), quint32(text.size()) };
+}
+
+// ============================================================================
+// NAME TABLE
+// ============================================================================
+
+quint32 NameTable::intern(const QString& name)
+{
+    auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 id = quint32(m_names.size());
+    m_ids.insert(name, id);
+    m_names.append(name);
+    return id;
+}
+
+void NameTable::clear()
+{
+    m_ids.clear();
+    m_names.clear();
+}
+
+qint64 NameTable::memoryUsage() const
+{
+    // Hash nodes are estimated; each name is counted once, with its header
+    qint64 bytes = qint64(m_names.capacity()) * qint64(sizeof(QString));
+    for (const QString& name : m_names) {
+        bytes += qint64(sizeof(QString)) + 2 * sizeof(void*) + sizeof(quint32);   // Hash node
+        bytes += 16 + qint64(name.capacity() + 1) * qint64(sizeof(QChar));
+    }
+    return bytes;
+}
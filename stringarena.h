@@ -0,0 +1,72 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+// ============================================================================
+// STRING ARENA
+// Text for the client's columnar tables (PostTable, MessageTable). Every
+// string is appended to one UTF-16 buffer and addressed by offset and
+// length, so a row holds 8 bytes per text column instead of a QString with
+// its own heap block. Text becomes a QString only when it is rendered.
+//
+// Append-only; clear() drops every string at once and keeps the buffer.
+// ============================================================================
+
+class StringArena
+{
+public:
+    struct Ref {
+        quint32 offset = 0;
+        quint32 length = 0;
+    };
+
+    Ref add(QStringView text);
+
+    QString text(Ref ref) const { return view(ref).toString(); }
+    QStringView view(Ref ref) const
+    {
+        return QStringView(m_chars.constData() + ref.offset, qsizetype(ref.length));
+    }
+
+    // Characters stored
+    int size() const { return m_chars.size(); }
+    int capacity() const { return m_chars.capacity(); }
+
+    void reserve(int chars) { m_chars.reserve(chars); }
+    void clear() { m_chars.clear(); }
+
+    qint64 memoryUsage() const { return qint64(m_chars.capacity()) * qint64(sizeof(QChar)); }
+
+private:
+    QVector<QChar> m_chars;
+};
+
+// ============================================================================
+// NAME TABLE
+// Interns names (authors, senders) to dense ids. Rows store the id; each
+// distinct name is one shared QString, so handing it out is a reference
+// count bump rather than a copy.
+// ============================================================================
+
+class NameTable
+{
+public:
+    quint32 intern(const QString& name);
+
+    const QString& name(quint32 id) const { return m_names.at(int(id)); }
+    int size() const { return m_names.size(); }
+
+    void clear();
+
+    qint64 memoryUsage() const;
+
+private:
+    QHash<QString, quint32> m_ids;
+    QVector<QString> m_names;
+};
+
+#endif // STRINGARENA_H
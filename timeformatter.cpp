@@ -0,0 +1,110 @@
+#include "timeformatter.h"
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+
+namespace {
+
+const int MaxClockLabels = 4096;      // Minutes cached before the cache starts over
+const int MaxRelativeLabels = 4096;   // Day counts are unbounded too
+
+enum Unit {
+    JustNow,
+    Minutes,
+    Hours,
+    Days
+};
+
+struct Cache {
+    QMutex mutex;
+    QHash<qint64, QString> relative;   // (unit << 32) | count
+    QHash<qint64, QString> clock;      // Minute since epoch
+};
+
+Cache& cache()
+{
+    static Cache labels;
+    return labels;
+}
+
+std::atomic<qint64> g_displayNow{ 0 };
+
+} // namespace
+
+QString TimeFormatter::relative(qint64 at, qint64 now)
+{
+    const qint64 secs = qMax<qint64>(0, now - at);
+    Unit unit = Days;
+    qint64 count = secs / 86400;
+    if (secs < 60) {
+        unit = JustNow;
+        count = 0;
+    } else if (secs < 3600) {
+        unit = Minutes;
+        count = secs / 60;
+    } else if (secs < 86400) {
+        unit = Hours;
+        count = secs / 3600;
+    }
+
+    const qint64 key = (qint64(unit) << 32) | count;
+    Cache& labels = cache();
+    QMutexLocker locker(&labels.mutex);
+    auto it = labels.relative.constFind(key);
+    if (it != labels.relative.constEnd()) {
+        return it.value();
+    }
+
+    if (labels.relative.size() >= MaxRelativeLabels) {
+        labels.relative.clear();
+    }
+    static const char* const Units[] = { "", "minute", "hour", "day" };
+    const QString text = unit == JustNow
+        ? QStringLiteral("just now")
+        : QString("%1 %2%3 ago").arg(count).arg(Units[unit]).arg(count == 1 ? "" : "s");
+    labels.relative.insert(key, text);
+    return text;
+}
+
+QString TimeFormatter::clock(qint64 at)
+{
+    const qint64 minute = at / 60;
+    Cache& labels = cache();
+    QMutexLocker locker(&labels.mutex);
+    auto it = labels.clock.constFind(minute);
+    if (it != labels.clock.constEnd()) {
+        return it.value();
+    }
+
+    if (labels.clock.size() >= MaxClockLabels) {
+        labels.clock.clear();
+    }
+    const QString text = QDateTime::fromSecsSinceEpoch(minute * 60).toString("h:mm AP");
+    labels.clock.insert(minute, text);
+    return text;
+}
+
+qint64 TimeFormatter::displayNow()
+{
+    qint64 now = g_displayNow.load(std::memory_order_relaxed);
+    if (now == 0) {
+        advance();
+        now = g_displayNow.load(std::memory_order_relaxed);
+    }
+    return now;
+}
+
+bool TimeFormatter::advance()
+{
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const qint64 previous = g_displayNow.exchange(now, std::memory_order_relaxed);
+    return previous / 60 != now / 60;
+}
+
+int TimeFormatter::msecsToNextMinute()
+{
+    const qint64 ms = QDateTime::currentMSecsSinceEpoch();
+    return int(60000 - ms % 60000);
+}
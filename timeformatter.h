@@ -0,0 +1,40 @@
+#ifndef TIMEFORMATTER_H
+#define TIMEFORMATTER_H
+
+#include <QString>
+
+// ============================================================================
+// TIME FORMATTER
+// Display strings for the epoch timestamps (seconds) in Post, Message and
+// the backend's lists (notifications, stories, conversation previews). Labels are rendered per bucket, not per item: every
+// post from 3 hours ago shares one cached "3 hours ago", every message
+// sent in one minute shares one "10:23 AM".
+//
+// Relative labels on screen are measured against displayNow(), a clock
+// that only moves when advance() is called. The client advances it once a
+// minute and repaints the visible labels in one batch, so they all change
+// together and the per-post card cache stays valid in between.
+//
+// Thread-safe.
+// ============================================================================
+
+class TimeFormatter
+{
+public:
+    // "just now", "5 minutes ago", "2 hours ago", "3 days ago"
+    static QString relative(qint64 at, qint64 now);
+    static QString relative(qint64 at) { return relative(at, displayNow()); }
+
+    // Wall-clock time of day, e.g. "10:23 AM"
+    static QString clock(qint64 at);
+
+    // Clock for on-screen relative labels, in seconds since epoch
+    static qint64 displayNow();
+    // Moves it to the current time; returns true when the minute changed
+    static bool advance();
+
+    // Milliseconds until the next whole minute, for the refresh timer
+    static int msecsToNextMinute();
+};
+
+#endif // TIMEFORMATTER_H
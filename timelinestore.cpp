@@ -0,0 +1,166 @@
+#include "timelinestore.h"
+#include <algorithm>
+
+namespace {
+
+bool before(const TimelineEntry& a, const TimelineEntry& b)
+{
+    return a.createdAt != b.createdAt ? a.createdAt < b.createdAt : a.record < b.record;
+}
+
+} // namespace
+
+TimelineStore::TimelineStore(const Options& options)
+    : m_options(options)
+{
+}
+
+void TimelineStore::Ring::push(const TimelineEntry& entry)
+{
+    const int capacity = slots.size();
+    if (capacity == 0) {
+        complete = false;
+        return;
+    }
+    if (size < capacity) {
+        at(size++) = entry;
+    } else {
+        // Overwrite the oldest entry
+        slots[head] = entry;
+        head = (head + 1) % capacity;
+        complete = false;
+    }
+
+    // New posts are the newest almost always; a skewed clock sinks them
+    for (int i = size - 1; i > 0 && before(at(i), at(i - 1)); --i) {
+        std::swap(at(i), at(i - 1));
+    }
+}
+
+TimelineStore::Ring TimelineStore::makeRing(const QVector<RankedPost>& newestFirst, int capacity,
+                                            bool complete) const
+{
+    Ring ring;
+    ring.slots.resize(qMax(0, capacity));
+    ring.size = qMin(newestFirst.size(), ring.slots.size());
+    ring.complete = complete && ring.size == newestFirst.size();
+    for (int i = 0; i < ring.size; ++i) {
+        const RankedPost& post = newestFirst.at(ring.size - 1 - i);
+        ring.slots[i] = { post.createdAt, post.record, post.authorId };
+    }
+    return ring;
+}
+
+void TimelineStore::materialize(quint32 viewer, const QVector<RankedPost>& regular, bool regularComplete,
+                                const QVector<RankedPost>& priority, bool priorityComplete)
+{
+    Timeline& timeline = m_timelines[viewer];
+    timeline.lanes[RegularLane] = makeRing(regular, m_options.regularCapacity, regularComplete);
+    timeline.lanes[PriorityLane] = makeRing(priority, m_options.priorityCapacity, priorityComplete);
+}
+
+void TimelineStore::push(quint32 viewer, Lane lane, const TimelineEntry& entry)
+{
+    auto it = m_timelines.find(viewer);
+    if (it != m_timelines.end()) {
+        it->lanes[lane].push(entry);
+    }
+}
+
+RankedPage TimelineStore::page(quint32 viewer, const FeedCursor& cursor, int pageSize, qint64 priorityBoost,
+                               const AuthorSet& skipAuthors, bool priorityOnly, bool* truncated) const
+{
+    RankedPage result{ {}, cursor, true };
+    *truncated = false;
+    auto it = m_timelines.constFind(viewer);
+    if (it == m_timelines.constEnd() || pageSize <= 0) {
+        return result;
+    }
+
+    qint64 afterScore = 0;
+    quint32 afterRecord = 0;
+    const bool resume = FeedRanker::decodeCursor(cursor, &afterScore, &afterRecord);
+
+    struct Reader {
+        const Ring* ring;
+        qint64 boost;
+        int pos;      // Next entry to read (walks towards the oldest)
+        bool priority;
+    };
+    // One reader per lane, on the stack
+    Reader readers[2];
+    int readerCount = 0;
+    for (int lane : { int(PriorityLane), int(RegularLane) }) {
+        if (priorityOnly && lane != PriorityLane) {
+            continue;
+        }
+        const Ring& ring = it->lanes[lane];
+        const qint64 boost = lane == PriorityLane ? priorityBoost : 0;
+
+        // First entry ranked strictly after the cursor (binary search)
+        int pos = ring.size - 1;
+        if (resume) {
+            const TimelineEntry key{ afterScore - boost, afterRecord, 0 };
+            int low = 0;
+            int high = ring.size;
+            while (low < high) {
+                const int mid = (low + high) / 2;
+                if (before(ring.at(mid), key)) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            pos = low - 1;
+        }
+        readers[readerCount++] = { &ring, boost, pos, lane == PriorityLane };
+    }
+
+    result.posts.reserve(pageSize);
+    while (result.posts.size() < pageSize) {
+        // A lane missing older entries cannot be ranked against past its end
+        Reader* best = nullptr;
+        bool stop = false;
+        for (int r = 0; r < readerCount; ++r) {
+            Reader& reader = readers[r];
+            if (reader.pos < 0) {
+                stop = stop || !reader.ring->complete;
+                continue;
+            }
+            const TimelineEntry& e = reader.ring->at(reader.pos);
+            if (!best) {
+                best = &reader;
+                continue;
+            }
+            const TimelineEntry& b = best->ring->at(best->pos);
+            const qint64 score = e.createdAt + reader.boost;
+            const qint64 bestScore = b.createdAt + best->boost;
+            if (score != bestScore ? score > bestScore : e.record > b.record) {
+                best = &reader;
+            }
+        }
+        if (stop) {
+            *truncated = true;
+            break;
+        }
+        if (!best) {
+            break;
+        }
+
+        const TimelineEntry& e = best->ring->at(best->pos--);
+        if (!skipAuthors.contains(e.authorId)) {
+            result.posts.append({ e.record, e.authorId, e.createdAt, e.createdAt + best->boost,
+                                  best->priority });
+        }
+    }
+
+    result.atEnd = !*truncated;
+    for (int r = 0; r < readerCount; ++r) {
+        result.atEnd = result.atEnd && readers[r].pos < 0;
+    }
+    if (!result.posts.isEmpty()) {
+        const RankedPost& last = result.posts.last();
+        result.next = FeedRanker::encodeCursor(last.score, last.record);
+    }
+    return result;
+}
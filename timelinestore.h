@@ -0,0 +1,95 @@
+#ifndef TIMELINESTORE_H
+#define TIMELINESTORE_H
+
+#include <QHash>
+#include <QVector>
+#include "feedranker.h"
+
+// ============================================================================
+// TIMELINE STORE
+// Materialized home timelines for fan-out on write. Each viewer gets two
+// bounded ring buffers of (createdAt, record, author), oldest first:
+//   priority lane - posts by followed close friends
+//   regular lane  - everyone else the viewer follows, plus their own posts
+// A new post is pushed onto each follower's lane in O(1), so reading a page
+// is a two-way merge of the lanes instead of a k-way merge over every
+// author stream.
+//
+// Timelines are built lazily (fan-out on read through the FeedRanker) the
+// first time a viewer reads and only then receive pushes, so idle accounts
+// cost nothing. A full ring drops its oldest entry; paging past the last
+// retained entry of such a lane is reported so the caller can continue
+// from the author streams. Authors above the celebrity threshold are never
+// pushed; the caller reads them on demand and merges them in.
+//
+// Not thread-safe: callers serialize writers against readers.
+// ============================================================================
+
+struct TimelineEntry {
+    qint64 createdAt;
+    quint32 record;      // Record number as used by the FeedRanker
+    quint32 authorId;
+};
+
+class TimelineStore
+{
+public:
+    enum Lane {
+        RegularLane,
+        PriorityLane
+    };
+
+    struct Options {
+        int regularCapacity = 500;      // Posts kept per viewer per lane
+        int priorityCapacity = 200;
+        int celebrityFollowers = 5000;  // Above this, authors are read on demand
+    };
+
+    explicit TimelineStore(const Options& options = Options());
+
+    const Options& options() const { return m_options; }
+    bool isCelebrity(int followerCount) const { return followerCount > m_options.celebrityFollowers; }
+
+    void clear() { m_timelines.clear(); }
+    int materializedCount() const { return m_timelines.size(); }
+    bool isMaterialized(quint32 viewer) const { return m_timelines.contains(viewer); }
+
+    // Installs a timeline built from the author streams (entries newest
+    // first, as FeedRanker::topK returns them). complete says whether the
+    // lane holds every post it should or older ones were left out.
+    void materialize(quint32 viewer, const QVector<RankedPost>& regular, bool regularComplete,
+                     const QVector<RankedPost>& priority, bool priorityComplete);
+    void evict(quint32 viewer) { m_timelines.remove(viewer); }
+
+    // Fan-out on write; ignored for viewers without a timeline
+    void push(quint32 viewer, Lane lane, const TimelineEntry& entry);
+
+    // Next pageSize posts after the cursor, priority lane boosted. Posts by
+    // skipAuthors are left out. Sets *truncated when a lane that dropped
+    // older entries ran out before the page was full.
+    RankedPage page(quint32 viewer, const FeedCursor& cursor, int pageSize, qint64 priorityBoost,
+                    const AuthorSet& skipAuthors, bool priorityOnly, bool* truncated) const;
+
+private:
+    struct Ring {
+        QVector<TimelineEntry> slots;
+        int head = 0;            // Slot of the oldest entry
+        int size = 0;
+        bool complete = true;    // Nothing has been dropped
+
+        const TimelineEntry& at(int i) const { return slots.at((head + i) % slots.size()); }
+        TimelineEntry& at(int i) { return slots[(head + i) % slots.size()]; }
+        void push(const TimelineEntry& entry);
+    };
+
+    struct Timeline {
+        Ring lanes[2];
+    };
+
+    Ring makeRing(const QVector<RankedPost>& newestFirst, int capacity, bool complete) const;
+
+    Options m_options;
+    QHash<quint32, Timeline> m_timelines;
+};
+
+#endif // TIMELINESTORE_H
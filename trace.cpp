@@ -0,0 +1,417 @@
+#include "trace.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const char* const TraceVariable = "PRIORITY_SOCIAL_TRACE";
+const char* const StatsVariable = "PRIORITY_SOCIAL_TRACE_STATS";
+const int BucketCount = 64;       // Power-of-two nanosecond buckets
+const int ChunkEvents = 4096;
+const int MaxChunks = 64;         // 256k events per thread, then dropped
+
+// Single writer: a plain load and store, no locked instruction. Readers
+// on other threads see a value that is at most one update old.
+template <typename T>
+void bump(std::atomic<T>& value, T delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct Histogram {
+    const char* name;
+    std::atomic<quint64> calls;
+    std::atomic<quint64> totalNs;
+    std::atomic<quint64> buckets[BucketCount];
+
+    explicit Histogram(const char* n)
+        : name(n)
+        , calls(0)
+        , totalNs(0)
+    {
+        for (std::atomic<quint64>& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+struct Counter {
+    const char* name;
+    std::atomic<qint64> value;
+
+    explicit Counter(const char* n)
+        : name(n)
+        , value(0)
+    {
+    }
+};
+
+struct Event {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// One per live thread, handed on to a new thread once its owner exits. The
+// owner records without locking; the mutex only guards adding a histogram
+// or counter against an exporter walking them.
+// Events are published through the count: a chunk and its slot are
+// written before the count that makes them visible.
+struct ThreadTables {
+    int tid = 0;
+    QString name;
+
+    QMutex mutex;
+    std::vector<std::unique_ptr<Histogram>> histograms;
+    std::vector<std::unique_ptr<Counter>> counters;
+
+    // Owner thread only
+    QHash<const char*, Histogram*> histogramIndex;
+    QHash<const char*, Counter*> counterIndex;
+
+    std::atomic<Event*> chunks[MaxChunks];
+    std::atomic<int> eventCount;
+    std::atomic<quint64> dropped;
+
+    ThreadTables()
+        : eventCount(0)
+        , dropped(0)
+    {
+        for (std::atomic<Event*>& chunk : chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadTables()
+    {
+        for (std::atomic<Event*>& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    Histogram* histogram(const char* key)
+    {
+        Histogram* found = histogramIndex.value(key);
+        if (!found) {
+            QMutexLocker locker(&mutex);
+            histograms.emplace_back(new Histogram(key));
+            found = histograms.back().get();
+            histogramIndex.insert(key, found);
+        }
+        return found;
+    }
+
+    Counter* counter(const char* key)
+    {
+        Counter* found = counterIndex.value(key);
+        if (!found) {
+            QMutexLocker locker(&mutex);
+            counters.emplace_back(new Counter(key));
+            found = counters.back().get();
+            counterIndex.insert(key, found);
+        }
+        return found;
+    }
+
+    void append(const Event& event)
+    {
+        const int index = eventCount.load(std::memory_order_relaxed);
+        const int chunkIndex = index / ChunkEvents;
+        if (chunkIndex >= MaxChunks) {
+            bump<quint64>(dropped, 1);
+            return;
+        }
+        Event* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Event[ChunkEvents];
+            chunks[chunkIndex].store(chunk, std::memory_order_relaxed);
+        }
+        chunk[index % ChunkEvents] = event;
+        eventCount.store(index + 1, std::memory_order_release);
+    }
+};
+
+struct TraceState {
+    QElapsedTimer clock;
+    QByteArray output;
+    int statsIntervalSecs = 0;
+    bool enabled = false;
+    bool finished = false;
+
+    // Tables outlive their threads, so their events are still exported.
+    // Pool workers exit when idle and respawn; a new thread takes over an
+    // exited one's table, so the count stays at the most threads alive at
+    // once.
+    QMutex registryMutex;
+    std::vector<std::unique_ptr<ThreadTables>> threads;
+    std::vector<ThreadTables*> idle;
+
+    TraceState()
+    {
+        clock.start();
+        output = qgetenv(TraceVariable);
+        statsIntervalSecs = qMax(0, qEnvironmentVariableIntValue(StatsVariable));
+        enabled = !output.isEmpty() || statsIntervalSecs > 0;
+    }
+};
+
+TraceState& state()
+{
+    static TraceState trace;
+    return trace;
+}
+
+// Gives the thread's table back when the thread exits
+struct TablesLease {
+    ThreadTables* tables = nullptr;
+
+    ~TablesLease()
+    {
+        if (tables) {
+            TraceState& trace = state();
+            QMutexLocker locker(&trace.registryMutex);
+            trace.idle.push_back(tables);
+        }
+    }
+};
+
+thread_local TablesLease t_lease;
+
+ThreadTables& tables()
+{
+    if (!t_lease.tables) {
+        TraceState& trace = state();
+        const QCoreApplication* app = QCoreApplication::instance();
+        const QString threadName = app && app->thread() == QThread::currentThread() ? QString("GUI")
+                                 : QThread::currentThread()->objectName();
+        QMutexLocker locker(&trace.registryMutex);
+        ThreadTables* taken = nullptr;
+        if (!trace.idle.empty()) {
+            // Keeps its events and totals; this thread records after them
+            taken = trace.idle.back();
+            trace.idle.pop_back();
+        } else {
+            trace.threads.emplace_back(new ThreadTables);
+            taken = trace.threads.back().get();
+            taken->tid = int(trace.threads.size());
+        }
+        taken->name = !threadName.isEmpty() ? threadName : QString("worker %1").arg(taken->tid);
+        t_lease.tables = taken;
+    }
+    return *t_lease.tables;
+}
+
+int bucketFor(qint64 ns)
+{
+    return ns <= 0 ? 0 : 63 - qCountLeadingZeroBits(quint64(ns));
+}
+
+// Geometric middle of the bucket holding the given fraction of calls
+double percentileMs(const quint64* buckets, quint64 calls, double fraction)
+{
+    const quint64 rank = quint64(fraction * (calls - 1));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            return (quint64(1) << i) * 1.41421356 / 1e6;
+        }
+    }
+    return 0.0;
+}
+
+double toUs(qint64 ns)
+{
+    return ns / 1e3;
+}
+
+} // namespace
+
+const bool Trace::s_enabled = state().enabled;
+
+qint64 Trace::now()
+{
+    return state().clock.nsecsElapsed();
+}
+
+void Trace::endScope(const char* name, qint64 startNs)
+{
+    TraceState& trace = state();
+    const qint64 durationNs = trace.clock.nsecsElapsed() - startNs;
+    ThreadTables& thread = tables();
+
+    Histogram* histogram = thread.histogram(name);
+    bump<quint64>(histogram->calls, 1);
+    bump<quint64>(histogram->totalNs, quint64(qMax<qint64>(0, durationNs)));
+    bump<quint64>(histogram->buckets[bucketFor(durationNs)], 1);
+
+    if (!trace.output.isEmpty()) {
+        thread.append({ name, startNs, durationNs });
+    }
+}
+
+void Trace::addToCounter(const char* name, qint64 delta)
+{
+    bump<qint64>(tables().counter(name)->value, delta);
+}
+
+void Trace::startStatsDump(QObject* owner)
+{
+    const int intervalSecs = state().statsIntervalSecs;
+    if (intervalSecs <= 0) {
+        return;
+    }
+    QTimer* timer = new QTimer(owner);
+    QObject::connect(timer, &QTimer::timeout, &Trace::dumpStats);
+    timer->start(intervalSecs * 1000);
+}
+
+void Trace::dumpStats()
+{
+    if (!s_enabled) {
+        return;
+    }
+
+    // Merged across threads by name: the same literal may have a
+    // different address in each translation unit
+    struct Merged {
+        quint64 calls = 0;
+        quint64 totalNs = 0;
+        quint64 buckets[BucketCount] = {};
+    };
+    QMap<QByteArray, Merged> scopes;
+    QMap<QByteArray, qint64> counters;
+    quint64 dropped = 0;
+    {
+        TraceState& trace = state();
+        QMutexLocker registry(&trace.registryMutex);
+        for (const std::unique_ptr<ThreadTables>& thread : trace.threads) {
+            QMutexLocker locker(&thread->mutex);
+            for (const std::unique_ptr<Histogram>& histogram : thread->histograms) {
+                Merged& merged = scopes[QByteArray(histogram->name)];
+                merged.calls += histogram->calls.load(std::memory_order_relaxed);
+                merged.totalNs += histogram->totalNs.load(std::memory_order_relaxed);
+                for (int i = 0; i < BucketCount; ++i) {
+                    merged.buckets[i] += histogram->buckets[i].load(std::memory_order_relaxed);
+                }
+            }
+            for (const std::unique_ptr<Counter>& counter : thread->counters) {
+                counters[QByteArray(counter->name)] += counter->value.load(std::memory_order_relaxed);
+            }
+            dropped += thread->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    QByteArray text = "-- trace stats --\n";
+    for (auto it = scopes.cbegin(); it != scopes.cend(); ++it) {
+        const Merged& merged = it.value();
+        if (merged.calls == 0) {
+            continue;
+        }
+        text += QString("%1  calls %2  mean %3 ms  p50 %4  p90 %5  p99 %6 ms\n")
+                    .arg(QString::fromLatin1(it.key()), -28)
+                    .arg(merged.calls)
+                    .arg(merged.totalNs / 1e6 / merged.calls, 0, 'f', 3)
+                    .arg(percentileMs(merged.buckets, merged.calls, 0.50), 0, 'f', 3)
+                    .arg(percentileMs(merged.buckets, merged.calls, 0.90), 0, 'f', 3)
+                    .arg(percentileMs(merged.buckets, merged.calls, 0.99), 0, 'f', 3)
+                    .toUtf8();
+    }
+    for (auto it = counters.cbegin(); it != counters.cend(); ++it) {
+        text += QString("%1  %2\n").arg(QString::fromLatin1(it.key()), -28).arg(it.value()).toUtf8();
+    }
+    if (dropped > 0) {
+        text += QString("%1 trace events dropped\n").arg(dropped).toUtf8();
+    }
+    std::fwrite(text.constData(), 1, size_t(text.size()), stderr);
+}
+
+void Trace::finish()
+{
+    TraceState& trace = state();
+    if (!trace.enabled || trace.finished) {
+        return;
+    }
+    trace.finished = true;
+
+    if (trace.statsIntervalSecs > 0) {
+        dumpStats();
+    }
+    if (trace.output.isEmpty()) {
+        return;
+    }
+
+    // Complete ("X") events per thread, named threads, then counter
+    // totals at the end of the timeline
+    const qint64 nowNs = trace.clock.nsecsElapsed();
+    QJsonArray events;
+    QMap<QByteArray, qint64> counters;
+    {
+        QMutexLocker registry(&trace.registryMutex);
+        for (const std::unique_ptr<ThreadTables>& thread : trace.threads) {
+            events.append(QJsonObject{
+                { "name", "thread_name" },
+                { "ph", "M" },
+                { "pid", 1 },
+                { "tid", thread->tid },
+                { "args", QJsonObject{ { "name", thread->name } } }
+            });
+
+            const int count = thread->eventCount.load(std::memory_order_acquire);
+            for (int i = 0; i < count; ++i) {
+                const Event& event = thread->chunks[i / ChunkEvents].load(std::memory_order_relaxed)[i % ChunkEvents];
+                events.append(QJsonObject{
+                    { "name", QString::fromLatin1(event.name) },
+                    { "cat", "app" },
+                    { "ph", "X" },
+                    { "ts", toUs(event.startNs) },
+                    { "dur", toUs(event.durationNs) },
+                    { "pid", 1 },
+                    { "tid", thread->tid }
+                });
+            }
+
+            QMutexLocker locker(&thread->mutex);
+            for (const std::unique_ptr<Counter>& counter : thread->counters) {
+                counters[QByteArray(counter->name)] += counter->value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    for (auto it = counters.cbegin(); it != counters.cend(); ++it) {
+        events.append(QJsonObject{
+            { "name", QString::fromLatin1(it.key()) },
+            { "ph", "C" },
+            { "ts", toUs(nowNs) },
+            { "pid", 1 },
+            { "args", QJsonObject{ { "value", double(it.value()) } } }
+        });
+    }
+
+    const QByteArray json = QJsonDocument(QJsonObject{
+        { "traceEvents", events },
+        { "displayTimeUnit", "ms" }
+    }).toJson(QJsonDocument::Compact);
+    if (trace.output == "-") {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stderr);
+        return;
+    }
+    QFile file(QString::fromLocal8Bit(trace.output));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qDebug() << "Could not write trace" << file.fileName() << ":" << file.errorString();
+    }
+}
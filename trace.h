@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+
+class QObject;
+
+// ============================================================================
+// TRACE
+// Hot-path instrumentation for the GUI thread and the backend workers:
+//   Trace::Scope   times a block; every name gets a duration histogram and,
+//                  when a trace file is written, one event per call
+//   Trace::count   adds to a named counter
+// Each thread records into its own tables with single-writer atomics, so
+// workers never wait on each other or on the GUI thread.
+//
+// Off unless one of these is set; when off, every call is a single branch:
+//   PRIORITY_SOCIAL_TRACE        Chrome trace-event JSON (chrome://tracing,
+//                                Perfetto) written on exit; "-" for stderr
+//   PRIORITY_SOCIAL_TRACE_STATS  seconds between stats dumps on stderr:
+//                                calls, mean, p50/p90/p99 per scope and
+//                                every counter
+// Names must be string literals; they are keyed by address.
+// ============================================================================
+
+class Trace
+{
+public:
+    // Records the time from construction to destruction under name
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name)
+            : m_name(name)
+            , m_startNs(s_enabled ? now() : -1)
+        {
+        }
+
+        ~Scope()
+        {
+            if (m_startNs >= 0) {
+                endScope(m_name, m_startNs);
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(Scope)
+
+        const char* m_name;
+        qint64 m_startNs;
+    };
+
+    static bool isEnabled() { return s_enabled; }
+
+    static void count(const char* name, qint64 delta = 1)
+    {
+        if (s_enabled) {
+            addToCounter(name, delta);
+        }
+    }
+
+    // Dumps stats every PRIORITY_SOCIAL_TRACE_STATS seconds on owner's
+    // thread; does nothing when that is not set
+    static void startStatsDump(QObject* owner);
+    static void dumpStats();
+
+    // Writes the trace file and a last stats dump; later calls do nothing
+    static void finish();
+
+private:
+    static qint64 now();
+    static void endScope(const char* name, qint64 startNs);
+    static void addToCounter(const char* name, qint64 delta);
+
+    static const bool s_enabled;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,321 @@
+#include "writeaheadlog.h"
+#include <QFileInfo>
+#include <QLockFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int FrameHeaderSize = 8;                   // length + crc32
+const int BodyHeaderSize = 1 + 8;                // type + sequence
+const quint32 MaxBodySize = 16 * 1024 * 1024;    // Anything larger is corruption
+const int WriteAttempts = 3;                     // Per batch, rolling back in between
+const unsigned long RetryDelayMs = 50;
+
+quint32 crc32(const char* data, qint64 size)
+{
+    static quint32 table[256];
+    static bool initialized = false;
+    if (!initialized) {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        initialized = true;
+    }
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool syncToDisk(QFile& file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog()
+{
+    crc32(nullptr, 0);   // Build the table before any thread can race on it
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    close();
+}
+
+bool WriteAheadLog::open(const QString& path, const ReplayHandler& replay, const Options& options)
+{
+    close();
+
+    m_options = options;
+
+    // Two processes appending would interleave batches. Held for as long as
+    // the log is open, so only a dead owner's lock counts as stale.
+    m_lock.reset(new QLockFile(path + ".lock"));
+    m_lock->setStaleLockTime(0);
+    if (!m_lock->tryLock()) {
+        m_error = QString("%1 is in use by another process").arg(QFileInfo(path).fileName());
+        m_lock.reset();
+        return false;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        m_error = m_file.errorString();
+        m_lock.reset();
+        return false;
+    }
+
+    if (!replayFile(replay)) {
+        m_file.close();
+        m_lock.reset();
+        return false;
+    }
+
+    m_stopping = false;
+    m_failed = false;
+    m_flusher = QThread::create([this]() { flushLoop(); });
+    m_flusher->start();
+    return true;
+}
+
+void WriteAheadLog::close()
+{
+    if (m_flusher) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopping = true;
+            m_wake.wakeAll();
+        }
+        m_flusher->wait();   // Drains everything still pending
+        delete m_flusher;
+        m_flusher = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_lock.reset();
+}
+
+QString WriteAheadLog::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+bool WriteAheadLog::replayFile(const ReplayHandler& replay)
+{
+    qint64 goodOffset = 0;
+    quint64 lastSequence = 0;
+    int replayed = 0;
+
+    while (true) {
+        const QByteArray header = m_file.read(FrameHeaderSize);
+        if (header.size() < FrameHeaderSize) {
+            break;
+        }
+        const quint32 length = qFromLittleEndian<quint32>(header.constData());
+        const quint32 crc = qFromLittleEndian<quint32>(header.constData() + 4);
+        if (length < quint32(BodyHeaderSize) || length > MaxBodySize) {
+            break;
+        }
+
+        const QByteArray body = m_file.read(length);
+        if (body.size() != int(length) || crc32(body.constData(), body.size()) != crc) {
+            break;
+        }
+
+        Record record;
+        record.type = RecordType(quint8(body.at(0)));
+        record.sequence = qFromLittleEndian<quint64>(body.constData() + 1);
+        record.payload = body.mid(BodyHeaderSize);
+        if (replay) {
+            replay(record);
+        }
+
+        lastSequence = qMax(lastSequence, record.sequence);
+        goodOffset = m_file.pos();
+        ++replayed;
+    }
+
+    // Drop a torn or corrupt tail so new frames follow the last good one
+    if (goodOffset != m_file.size()) {
+        qDebug() << "WAL: discarding" << (m_file.size() - goodOffset)
+                 << "bytes of incomplete log after" << replayed << "records";
+        if (!m_file.resize(goodOffset)) {
+            m_error = m_file.errorString();
+            return false;
+        }
+    }
+    if (!m_file.seek(goodOffset)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    lastSequence = qMax(lastSequence, m_options.minSequence);
+    QMutexLocker locker(&m_mutex);
+    m_nextSequence = lastSequence + 1;
+    m_pendingSequence = lastSequence;
+    m_durableSequence = lastSequence;
+    m_durableSize = goodOffset;
+    m_pending.clear();
+    return true;
+}
+
+quint64 WriteAheadLog::append(RecordType type, const QByteArray& payload)
+{
+    const quint32 length = quint32(BodyHeaderSize + payload.size());
+
+    QMutexLocker locker(&m_mutex);
+    if (m_failed) {
+        return 0;   // Nothing may follow a batch that never reached the disk
+    }
+    const quint64 sequence = m_nextSequence++;
+
+    // Frame is assembled in place at the end of the pending batch
+    const int frameStart = m_pending.size();
+    m_pending.resize(frameStart + FrameHeaderSize + int(length));
+    char* frame = m_pending.data() + frameStart;
+    char* body = frame + FrameHeaderSize;
+    body[0] = char(type);
+    qToLittleEndian<quint64>(sequence, body + 1);
+    std::memcpy(body + BodyHeaderSize, payload.constData(), size_t(payload.size()));
+    qToLittleEndian<quint32>(length, frame);
+    qToLittleEndian<quint32>(crc32(body, length), frame + 4);
+    m_pendingSequence = sequence;
+
+    // Wake the flusher for a new batch, or early once the batch is full.
+    // Otherwise it is already waiting out the commit interval.
+    if (frameStart == 0 || m_pending.size() >= m_options.commitBytes) {
+        m_wake.wakeOne();
+    }
+    return sequence;
+}
+
+bool WriteAheadLog::waitDurable(quint64 sequence, unsigned long timeoutMs)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_durableSequence < sequence && !m_failed) {
+        if (!m_durableWake.wait(&m_mutex, timeoutMs)) {
+            return false;
+        }
+    }
+    return m_durableSequence >= sequence;
+}
+
+bool WriteAheadLog::hasFailed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_failed;
+}
+
+quint64 WriteAheadLog::durableSequence() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_durableSequence;
+}
+
+quint64 WriteAheadLog::commitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_commits;
+}
+
+bool WriteAheadLog::writeBatch(const QByteArray& batch, QString* error)
+{
+    for (int attempt = 1; attempt <= WriteAttempts; ++attempt) {
+        if (m_file.write(batch) == batch.size() && syncToDisk(m_file)) {
+            return true;
+        }
+        *error = m_file.errorString();
+        qDebug() << "WAL: group commit attempt" << attempt << "failed:" << *error;
+        if (!rollback()) {
+            return false;
+        }
+        QThread::msleep(RetryDelayMs);
+    }
+    return false;
+}
+
+bool WriteAheadLog::rollback()
+{
+    // Reopening drops whatever QFile still buffers from the failed write;
+    // the resize cuts any partial frame that did reach the file
+    const QString path = m_file.fileName();
+    m_file.close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite) || !m_file.resize(m_durableSize) || !m_file.seek(m_durableSize)) {
+        qDebug() << "WAL: could not roll back to offset" << m_durableSize << ":" << m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void WriteAheadLog::flushLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (m_pending.isEmpty() && !m_stopping) {
+            m_wake.wait(&m_mutex);
+        }
+        if (m_pending.isEmpty()) {
+            break;   // Stopping with nothing left to write
+        }
+
+        // Group window: let concurrent writers join this batch
+        if (!m_stopping && m_pending.size() < m_options.commitBytes) {
+            m_wake.wait(&m_mutex, ulong(m_options.commitIntervalMs));
+        }
+
+        QByteArray batch;
+        batch.swap(m_pending);
+        const quint64 batchSequence = m_pendingSequence;
+
+        // m_durableSize is only written here, so it is read unlocked below
+        QString error;
+        locker.unlock();
+        const bool ok = writeBatch(batch, &error);
+        locker.relock();
+
+        if (ok) {
+            m_durableSequence = batchSequence;
+            m_durableSize += batch.size();
+            ++m_commits;
+        } else {
+            // Stop for good: a later batch behind a torn frame would be
+            // dropped by the next replay even after being reported durable
+            m_failed = true;
+            m_error = error;
+            m_pending.clear();
+            qDebug() << "WAL: group commit failed, refusing further records:" << m_error;
+        }
+        m_durableWake.wakeAll();
+        if (m_failed) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+#include <QWaitCondition>
+#include <climits>
+#include <functional>
+
+class QLockFile;
+class QThread;
+
+// ============================================================================
+// WRITE-AHEAD LOG
+// One append-only, checksummed log shared by every mutation type (likes,
+// messages, close-friend toggles, follows, posts, stories). Appends only
+// copy into a pending buffer; a flusher thread writes and fsyncs the whole
+// buffer at once when the commit interval expires or the buffer crosses
+// the size threshold, so a burst of mutations costs one fsync per batch.
+//
+// Frame layout (little-endian):
+//   quint32 length   size of the body below
+//   quint32 crc32    checksum of the body
+//   body:  quint8 type, quint64 sequence, payload bytes
+//
+// open() replays every intact frame and truncates a torn tail left by a
+// crash, so recovery stops at the last fully written record. A batch whose
+// write fails is cut back off the file and retried; if it still fails the
+// log stops accepting records (append() returns 0) rather than write more
+// frames behind a torn one.
+//
+// One process owns the log while it is open (a lock file beside it); open()
+// fails in any other process sharing the data directory.
+// ============================================================================
+
+class WriteAheadLog
+{
+public:
+    enum RecordType : quint8 {
+        LikePost = 1,
+        SendMessage = 2,
+        CloseFriendStatus = 3,
+        Follow = 4,
+        CloseFriend = 5,
+        CreatePost = 6,
+        NotificationsRead = 7,
+        CreateStory = 8
+    };
+
+    struct Record {
+        RecordType type;
+        quint64 sequence;
+        QByteArray payload;
+    };
+
+    struct Options {
+        int commitIntervalMs = 5;        // Max time a record waits for its batch
+        int commitBytes = 64 * 1024;     // Flush early once this much is pending
+        // Highest sequence a store may already hold: records applied
+        // before their commit was torn off by a crash. Numbering resumes
+        // after it so those sequences are never reissued.
+        quint64 minSequence = 0;
+    };
+
+    using ReplayHandler = std::function<void(const Record&)>;
+
+    WriteAheadLog();
+    ~WriteAheadLog();
+
+    bool open(const QString& path, const ReplayHandler& replay, const Options& options = Options());
+    void close();
+    bool isOpen() const { return m_flusher != nullptr; }
+    QString errorString() const;
+
+    // Queues a record for the next group commit and returns its sequence,
+    // or 0 once a commit has failed (see hasFailed())
+    quint64 append(RecordType type, const QByteArray& payload);
+
+    // Blocks until the record with this sequence has been fsynced
+    bool waitDurable(quint64 sequence, unsigned long timeoutMs = ULONG_MAX);
+
+    bool hasFailed() const;
+    quint64 durableSequence() const;
+    quint64 commitCount() const;
+
+private:
+    Q_DISABLE_COPY(WriteAheadLog)
+
+    bool replayFile(const ReplayHandler& replay);
+    bool writeBatch(const QByteArray& batch, QString* error);
+    bool rollback();
+    void flushLoop();
+
+    QFile m_file;
+    QScopedPointer<QLockFile> m_lock;   // Held from open() to close()
+    Options m_options;
+    QThread* m_flusher = nullptr;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;          // Flusher: work pending or stop requested
+    QWaitCondition m_durableWake;   // Writers waiting in waitDurable()
+    QByteArray m_pending;
+    quint64 m_nextSequence = 1;
+    quint64 m_pendingSequence = 0;
+    quint64 m_durableSequence = 0;
+    qint64 m_durableSize = 0;       // File size after the last good commit
+    quint64 m_commits = 0;
+    bool m_stopping = false;
+    bool m_failed = false;
+    QString m_error;
+};
+
+#endif // WRITEAHEADLOG_H